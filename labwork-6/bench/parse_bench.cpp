@@ -0,0 +1,186 @@
+// Route parsing benchmark: ParseJson over a json::parse DOM against the
+// streaming ParseRoutes, on recorded responses (e.g. the files of a
+// ROUTES_FIXTURES directory) or, without arguments, on a generated one
+// with 60 segments, half of them with transfers. Both paths must give the
+// same routes.
+//
+//   g++ -std=c++17 -O2 bench/parse_bench.cpp save_algo/*.cpp cache/*.cpp
+//   ./a.out [rounds] [response.json...]
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../save_algo/route_parser.h"
+#include "../save_algo/save_route.h"
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+json Station(int i) {
+    return {{"type", "station"},
+            {"title", i % 7 == 0 ? json() : json("Station " +
+                                                 std::to_string(i))},
+            {"popular_title", "Popular " + std::to_string(i)},
+            {"short_title", nullptr},
+            {"code", "s" + std::to_string(9600000 + i)},
+            {"station_type", "train_station"},
+            {"transport_type", "train"}};
+}
+
+json Thread(int i) {
+    return {{"number", std::to_string(6000 + i)},
+            {"title", "Saint-Petersburg — Pskov " + std::to_string(i)},
+            {"short_title", "SPb — Pskov"},
+            {"carrier",
+             {{"code", 112},
+              {"title", "Northwestern Suburban Passenger Company"},
+              {"codes", {{"sirena", nullptr}, {"iata", nullptr}}},
+              {"contacts", "Phone: +7 800 000-00-00"}}},
+            {"transport_type", i % 3 ? "suburban" : "bus"},
+            {"vehicle", nullptr},
+            {"uid", "6000_" + std::to_string(i) + "_9602494_g25_4"}};
+}
+
+json Tickets(int price) {
+    return {{"et_marker", false},
+            {"places",
+             {{{"currency", "RUB"},
+               {"price", {{"cents", 50}, {"whole", price}}},
+               {"name", nullptr}}}}};
+}
+
+json Leg(int i) {
+    return {{"from", Station(i)},
+            {"to", Station(i + 1)},
+            {"thread", Thread(i)},
+            {"departure", "2026-11-01T08:" + std::to_string(10 + i % 50) +
+                              ":00+03:00"},
+            {"arrival", "2026-11-01T12:" + std::to_string(10 + i % 50) +
+                            ":00+03:00"},
+            {"duration", 14400.0},
+            {"stops", "everywhere"},
+            {"has_transfers", false},
+            {"tickets_info", Tickets(300 + i)}};
+}
+
+std::string MakeResponse(int segments) {
+    json response = {{"search",
+                      {{"from", {{"code", "c2"}, {"title", "SPb"}}},
+                       {"to", {{"code", "c25"}, {"title", "Pskov"}}},
+                       {"date", "2026-11-01"}}},
+                     {"segments", json::array()},
+                     {"interval_segments", json::array()},
+                     {"pagination",
+                      {{"total", segments}, {"limit", 100}, {"offset", 0}}}};
+    for (int i = 0; i < segments; ++i) {
+        if (i % 2 == 0) {
+            json leg = Leg(i);
+            if (i % 10 == 4) {
+                leg.erase("from");  // The segment's own titles are used
+            }
+            response["segments"].push_back(leg);
+            continue;
+        }
+        json details = json::array();
+        for (int j = 0; j < 3; ++j) {
+            details.push_back(Leg(i * 10 + j));
+            if (j < 2) {
+                details.push_back({{"is_transfer", true},
+                                   {"transfer_point", Station(i + j)},
+                                   {"duration", 1800}});
+            }
+        }
+        response["segments"].push_back(
+            {{"departure_from", Station(i)},
+             {"arrival_to", Station(i + 5)},
+             {"departure", "2026-11-01T06:00:00+03:00"},
+             {"arrival", "2026-11-01T13:30:00+03:00"},
+             {"has_transfers", true},
+             {"transfers", {Station(i + 2), Station(i + 3)}},
+             {"transport_types", {"suburban", "bus"}},
+             {"details", details}});
+    }
+    return response.dump();
+}
+
+bool SameRoutes(const std::vector<Route>& a, const std::vector<Route>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        const Route& x = a[i];
+        const Route& y = b[i];
+        if (x.from != y.from || x.to != y.to || x.departure != y.departure ||
+            x.arrival != y.arrival || x.thread_title != y.thread_title ||
+            x.transport_type != y.transport_type ||
+            x.is_transfer != y.is_transfer || x.price != y.price ||
+            (x.is_transfer ? x.transfer_count != y.transfer_count
+                           : x.thread_number != y.thread_number)) {
+            std::cerr << "Routes differ at " << i << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::vector<std::string> bodies;
+    for (int i = 2; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        std::ostringstream content;
+        content << file.rdbuf();
+        bodies.push_back(content.str());
+    }
+    if (bodies.empty()) {
+        bodies.push_back(MakeResponse(60));
+    }
+
+    size_t bytes = 0;
+    for (const std::string& body : bodies) {
+        bytes += body.size();
+        std::vector<Route> streamed;
+        if (ParseRoutes(body, streamed) == ParseStatus::kInvalidJson ||
+            !SameRoutes(ParseJson(json::parse(body)), streamed)) {
+            std::cerr << "Streaming parser disagrees with ParseJson" << '\n';
+            return 1;
+        }
+    }
+
+    size_t routes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const std::string& body : bodies) {
+            routes += ParseJson(json::parse(body)).size();
+        }
+    }
+    double dom = SecondsSince(start);
+
+    std::vector<Route> streamed;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const std::string& body : bodies) {
+            ParseRoutes(body, streamed);
+            routes += streamed.size();
+        }
+    }
+    double sax = SecondsSince(start);
+
+    double megabytes = static_cast<double>(bytes) * rounds / 1e6;
+    std::cerr << "dom\t" << dom << " s, " << megabytes / dom << " MB/s\n"
+              << "sax\t" << sax << " s, " << megabytes / sax << " MB/s\n"
+              << routes / 2 / rounds << " routes per round" << '\n';
+    return 0;
+}
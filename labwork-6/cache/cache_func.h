@@ -6,6 +6,4 @@
 
 void SaveToFile(std::string& filename, const std::string& data);
 
-bool CheckiInFile(const std::string& filename, std::string& data);
-
 void DeleteFromFile(std::string& filename);
@@ -0,0 +1,190 @@
+#include "route_cache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+RouteCache::RouteCache(const std::string& path, int64_t ttl_seconds)
+    : path_(path), ttl_seconds_(ttl_seconds) {
+    Load();
+    Open();
+    if (records_ >= kMinCompactRecords && records_ > 2 * index_.size()) {
+        Compact();
+    }
+}
+
+std::string RouteCache::MakeKey(const std::string& from, const std::string& to,
+                                const std::string& date) {
+    return from + '\t' + to + '\t' + date;
+}
+
+bool RouteCache::IsExpired(const Entry& entry) const {
+    return ttl_seconds_ > 0 &&
+           static_cast<int64_t>(std::time(nullptr)) - entry.stored_at >=
+               ttl_seconds_;
+}
+
+void RouteCache::Load() {
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+
+    std::string header;
+    uint64_t end = 0;  // Past the last complete record
+    while (std::getline(file, header)) {
+        size_t tab = header.rfind('\t');
+        uint64_t size = 0;
+        if (tab == std::string::npos ||
+            std::from_chars(header.data() + tab + 1,
+                            header.data() + header.size(), size)
+                    .ec != std::errc()) {
+            break;
+        }
+        // Records written before the TTL have no stored_at and are stale
+        int64_t stored_at = 0;
+        size_t time_tab = header.rfind('\t', tab - 1);
+        if (std::count(header.begin(), header.begin() + tab, '\t') == 3) {
+            std::from_chars(header.data() + time_tab + 1, header.data() + tab,
+                            stored_at);
+            tab = time_tab;
+        }
+
+        uint64_t offset = end + header.size() + 1;
+        char newline = 0;
+        file.seekg(offset + size);
+        if (!file.get(newline) || newline != '\n') {
+            break;
+        }
+        header.resize(tab);
+        index_[header] = {offset, size, stored_at};
+        ++records_;
+        end = offset + size + 1;
+    }
+    file.close();
+
+    log_size_ = end;
+    std::error_code error;
+    if (std::filesystem::file_size(path_, error) > end && !error) {
+        std::cerr << "Cache file is damaged, dropping its tail\n";
+        std::filesystem::resize_file(path_, end, error);
+    }
+}
+
+void RouteCache::Open() {
+    writer_.close();
+    reader_.close();
+    writer_.open(path_, std::ios::binary | std::ios::app);
+    reader_.open(path_, std::ios::binary);
+    if (!writer_.is_open() || !reader_.is_open()) {
+        std::cerr << "Cache file could not be opened!\n";
+    }
+}
+
+bool RouteCache::Get(const std::string& from, const std::string& to,
+                     const std::string& date, std::string& value,
+                     int64_t* stored_at) {
+    auto it = index_.find(MakeKey(from, to, date));
+    if (it == index_.end()) {
+        return false;
+    }
+    if (IsExpired(it->second)) {
+        index_.erase(it);
+        return false;
+    }
+    if (stored_at) {
+        *stored_at = it->second.stored_at;
+    }
+    value.resize(it->second.size);
+    reader_.clear();
+    reader_.seekg(it->second.offset);
+    return static_cast<bool>(reader_.read(&value[0], value.size()));
+}
+
+bool RouteCache::Contains(const std::string& from, const std::string& to,
+                          const std::string& date) const {
+    auto it = index_.find(MakeKey(from, to, date));
+    return it != index_.end() && !IsExpired(it->second);
+}
+
+bool RouteCache::Put(const std::string& from, const std::string& to,
+                     const std::string& date, const std::string& value) {
+    std::string key = MakeKey(from, to, date);
+    if (key.find('\n') != std::string::npos ||
+        std::count(key.begin(), key.end(), '\t') != 2) {
+        return false;
+    }
+
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    std::string header = key + '\t' + std::to_string(now) + '\t' +
+                         std::to_string(value.size()) + '\n';
+    writer_.write(header.data(), header.size());
+    writer_.write(value.data(), value.size());
+    writer_.put('\n');
+    if (!writer_.flush()) {
+        writer_.clear();
+        return false;
+    }
+
+    index_[key] = {log_size_ + header.size(), value.size(), now};
+    log_size_ += header.size() + value.size() + 1;
+    ++records_;
+    if (records_ >= kMinCompactRecords && records_ > 2 * index_.size()) {
+        Compact();
+    }
+    return true;
+}
+
+// Live records go to a new file that then replaces the log
+void RouteCache::Compact() {
+    std::string temp_path = path_ + ".tmp";
+    std::ofstream temp(temp_path, std::ios::binary | std::ios::trunc);
+    if (!temp.is_open()) {
+        return;
+    }
+
+    std::unordered_map<std::string, Entry> index;
+    index.reserve(index_.size());
+    uint64_t size = 0;
+    std::string value;
+    bool ok = true;
+    for (const auto& [key, entry] : index_) {
+        if (IsExpired(entry)) {
+            continue;
+        }
+        value.resize(entry.size);
+        reader_.clear();
+        reader_.seekg(entry.offset);
+        if (!reader_.read(&value[0], value.size())) {
+            ok = false;
+            break;
+        }
+        std::string header = key + '\t' + std::to_string(entry.stored_at) +
+                             '\t' + std::to_string(value.size()) + '\n';
+        temp.write(header.data(), header.size());
+        temp.write(value.data(), value.size());
+        temp.put('\n');
+        index[key] = {size + header.size(), value.size(), entry.stored_at};
+        size += header.size() + value.size() + 1;
+    }
+    ok = ok && temp.flush();
+    temp.close();
+
+    std::error_code error;
+    if (!ok) {
+        std::filesystem::remove(temp_path, error);
+        return;
+    }
+    writer_.close();
+    reader_.close();
+    std::filesystem::rename(temp_path, path_, error);
+    if (!error) {
+        index_.swap(index);
+        log_size_ = size;
+        records_ = index_.size();
+    }
+    Open();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+// On-disk cache of search responses keyed by (from, to, date).
+//
+// The file is an append-only log of records
+//     from \t to \t date \t stored_at \t size \n <size bytes of value> \n
+// where a later record for the same key replaces an earlier one and
+// stored_at is in seconds since the epoch. The log is scanned once in the
+// constructor (headers only, values are skipped) into a hash index of
+// value offsets, so a lookup is one hash probe and one read. With a TTL,
+// older records are misses and count as superseded. Once superseded
+// records outnumber live ones the log is rewritten with live records
+// only. A record cut short by a crash is dropped on the next start.
+class RouteCache {
+   public:
+    // ttl_seconds 0 - records never expire
+    explicit RouteCache(const std::string& path, int64_t ttl_seconds = 0);
+
+    // stored_at, if given, gets the time of the record
+    bool Get(const std::string& from, const std::string& to,
+             const std::string& date, std::string& value,
+             int64_t* stored_at = nullptr);
+    bool Contains(const std::string& from, const std::string& to,
+                  const std::string& date) const;
+    // False if a key part has a tab or a newline or the file is not
+    // writable
+    bool Put(const std::string& from, const std::string& to,
+             const std::string& date, const std::string& value);
+
+    void Compact();
+    size_t Size() const { return index_.size(); }
+
+   private:
+    struct Entry {
+        uint64_t offset;  // Of the value in the log
+        uint64_t size;
+        int64_t stored_at;
+    };
+
+    static constexpr size_t kMinCompactRecords = 64;
+
+    std::string path_;
+    int64_t ttl_seconds_;
+    std::unordered_map<std::string, Entry> index_;
+    std::ifstream reader_;
+    std::ofstream writer_;
+    uint64_t log_size_ = 0;
+    uint64_t records_ = 0;  // Live and superseded
+
+    static std::string MakeKey(const std::string& from, const std::string& to,
+                               const std::string& date);
+    bool IsExpired(const Entry& entry) const;
+    void Load();
+    void Open();
+};
@@ -1,28 +1,93 @@
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <vector>
 
 #include "cache/cache_func.h"
 #include "main_p/api_manager.h"
+#include "main_p/search_cache.h"
 #include "save_algo/save_route.h"
 
-bool IsSegmentsKey(const std::pair<const std::string, nlohmann::json>& item) {
-    return item.first == "segments";
+// Responses are reused for a day
+const int64_t kCacheTtlSeconds = 24 * 60 * 60;
+// Requests to the API at once
+const size_t kMaxInFlight = 4;
+// Longest range of a flexible date
+const int kMaxFlexibleDays = 30;
+
+// ROUTES_FIXTURES=<dir> replays recorded JSON, ROUTES_URL=<url> talks to a
+// local fixture server; otherwise the live API
+std::unique_ptr<ApiManager> MakeApiManager() {
+    if (const char* directory = std::getenv("ROUTES_FIXTURES")) {
+        return std::make_unique<ApiManager>(
+            std::make_unique<DirectoryTransport>(directory), "");
+    }
+    if (const char* url = std::getenv("ROUTES_URL")) {
+        return std::make_unique<ApiManager>(std::make_unique<HttpTransport>(),
+                                            url);
+    }
+    return std::make_unique<ApiManager>();
+}
+
+// "YYYY-MM-DD" or "YYYY-MM-DD+N" for that date and N days after it
+std::vector<std::string> TripDates(const std::string& input) {
+    size_t plus = input.find('+');
+    std::tm first = {};
+    std::istringstream stream(input.substr(0, plus));
+    stream >> std::get_time(&first, "%Y-%m-%d");
+    if (plus == std::string::npos || stream.fail()) {
+        return {input};
+    }
+
+    int days = std::min(std::atoi(input.c_str() + plus + 1), kMaxFlexibleDays);
+    std::vector<std::string> dates;
+    for (int day = 0; day <= days; ++day) {
+        std::tm date = first;
+        date.tm_mday += day;
+        date.tm_hour = 12;  // Away from DST shifts
+        std::mktime(&date);
+        char text[16];
+        std::strftime(text, sizeof(text), "%Y-%m-%d", &date);
+        dates.push_back(text);
+    }
+    return dates;
+}
+
+// False if there is nothing to print
+bool PrintResponse(const SearchResult& result, std::string& filename) {
+    if (!result.found) {
+        std::cout << "Failed to get route information. Please check your "
+                     "internet connection and try again.\n";
+        return false;
+    }
+    if (!result.has_segments) {
+        std::cout << "No routes found for the specified date.\n";
+        return false;
+    }
+    if (result.routes.empty()) {
+        std::cout << "No valid routes found for the specified date.\n";
+        return false;
+    }
+    PrintRoutes(result.routes, filename);
+    return true;
 }
 
 int main() {
-    ApiManager api_manager;
+    std::unique_ptr<ApiManager> api_manager = MakeApiManager();
+    SearchCache search(*api_manager, "routes.cache", kCacheTtlSeconds);
     std::string from = "c2";  // Saint-Petersburg
     std::string to = "c25";   // Pskov
     std::string date;
     std::string filename;
     std::string answer;
-    std::vector<std::string> dates;
-    std::vector<Route> routes;
-    std::vector<Route> routes2;
 
     while (true) {
         //-----1-----
-        std::cout << "What is date of your trip to Pskov? YYYY-MM-DD: ";
+        std::cout << "What is date of your trip to Pskov? YYYY-MM-DD[+days]: ";
         std::cin >> date;
         std::cout << '\n';
 
@@ -31,68 +96,32 @@ int main() {
         std::cin >> filename;
         std::cout << '\n';
 
-        //-----Check for duplicates-----
-        if (!dates.empty()) {
-            std::cout << "First check: Memory\n";
-            for (auto& date_v : dates) {
-                if (date_v == date) {
-                    std::cout << "You have already searched for this date!\n";
-                    continue;
-                }
-            }
-            std::cout << "Second check: File\n";
-            if (CheckiInFile(filename, date)) {
-                std::cout << "You have already searched for this date!\n";
-                continue;
-            } else {
-                dates.push_back(date);
-            }
-        } else {
-            dates.push_back(date);
-        }
-
         //-----2.1-----
-        nlohmann::json response = api_manager.Search(from, to, date);
-        if (response.is_null()) {
-            std::cout << "Failed to get route information. Please check your "
-                         "internet connection and try again.\n";
-            continue;
-        }
-        if (!response.contains("segments")) {
-            std::cout << "No routes found for the specified date.\n";
-            continue;
-        }
-        routes = ParseJson(response);
-        if (routes.empty()) {
-            std::cout << "No valid routes found for the specified date.\n";
-            continue;
+        // Both directions of every date at once, printed in the order of
+        // the dates, there before back
+        std::vector<std::string> dates = TripDates(date);
+        std::vector<SearchQuery> queries;
+        for (const std::string& trip_date : dates) {
+            queries.push_back({from, to, trip_date});
+            queries.push_back({to, from, trip_date});
         }
-        PrintRoutes(routes, filename);
+        std::vector<SearchResult> results =
+            search.SearchAll(queries, kMaxInFlight);
 
         //-----2.2-----
-        nlohmann::json response2 = api_manager.Search(to, from, date);
-        if (response2.is_null()) {
-            std::cout << "Failed to get route information. Please check your "
-                         "internet connection and try again.\n";
-            continue;
-        }
-
-        // begin 
-
-        if (std::find_if(response2.begin(), response2.end(), IsSegmentsKey) ==
-            response2.end()) {
-            std::cout << "No routes found for the specified date.\n";
-            continue;
+        bool found = false;
+        for (size_t i = 0; i < dates.size(); ++i) {
+            if (dates.size() > 1) {
+                std::cout << dates[i] << ":\n";
+            }
+            if (PrintResponse(results[2 * i], filename) &&
+                PrintResponse(results[2 * i + 1], filename)) {
+                found = true;
+            }
         }
-        
-        // end
-
-        routes2 = ParseJson(response2);
-        if (routes2.empty()) {
-            std::cout << "No valid routes found for the specified date.\n";
+        if (!found) {
             continue;
         }
-        PrintRoutes(routes2, filename);
 
         //-----3-----
         std::cout << "Do you want to clean this file? (y/n): ";
@@ -100,9 +129,6 @@ int main() {
         std::cout << '\n';
         if (answer == "y") {
             DeleteFromFile(filename);
-            if (!dates.empty()) {
-                dates.pop_back();
-            }
         }
 
         //-----4-----
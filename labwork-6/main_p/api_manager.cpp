@@ -1,32 +1,46 @@
 #include "api_manager.h"
 
-ApiManager::ApiManager() {}
+ApiManager::ApiManager() : transport_(std::make_unique<HttpTransport>()) {}
 
-nlohmann::json ApiManager::Search(const std::string& from,
-                                  const std::string& to,
-                                  const std::string& date) {
+ApiManager::ApiManager(std::unique_ptr<Transport> transport,
+                       const std::string& url)
+    : url(url), transport_(std::move(transport)) {}
+
+bool ApiManager::Fetch(const std::string& from, const std::string& to,
+                       const std::string& date, std::string& body) {
     try {
-        cpr::Response r = cpr::Get(cpr::Url{url},
-                                   cpr::Parameters{{"apikey", api_key_},
-                                                   {"from", from},
-                                                   {"to", to},
-                                                   {"date", date},
-                                                   {"transfers", "true"},
-                                                   {"limit", "50"}},
-                                   cpr::Timeout{30000});
-
-        if (r.status_code != 200) {
-            std::cerr << "HTTP Error: " << r.status_code << "\n";
-            std::cerr << "Error message: " << r.error.message << "\n";
-            return nullptr;
+        if (!transport_->Get(url,
+                             {{"apikey", api_key_},
+                              {"from", from},
+                              {"to", to},
+                              {"date", date},
+                              {"transfers", "true"},
+                              {"limit", "50"}},
+                             body)) {
+            return false;
         }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return false;
+    }
 
-        if (r.text.empty()) {
-            std::cerr << "Empty response from server\n";
-            return nullptr;
-        }
+    if (body.empty()) {
+        std::cerr << "Empty response from server\n";
+        return false;
+    }
+    return true;
+}
 
-        auto json_response = nlohmann::json::parse(r.text);
+nlohmann::json ApiManager::Search(const std::string& from,
+                                  const std::string& to,
+                                  const std::string& date) {
+    std::string body;
+    if (!Fetch(from, to, date, body)) {
+        return nullptr;
+    }
+
+    try {
+        auto json_response = nlohmann::json::parse(body);
         if (json_response.is_null()) {
             std::cerr << "Invalid JSON response\n";
             return nullptr;
@@ -37,8 +51,5 @@ nlohmann::json ApiManager::Search(const std::string& from,
     } catch (const nlohmann::json::parse_error& e) {
         std::cerr << "JSON parsing error: " << e.what() << "\n";
         return nullptr;
-    } catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << "\n";
-        return nullptr;
     }
 }
\ No newline at end of file
@@ -1,18 +1,28 @@
 #pragma once
 
-#include <cpr/cpr.h>
-
 #include <iostream>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <string>
 
+#include "transport.h"
+
 class ApiManager {
    public:
+    // Live API over HTTP
     ApiManager();
+    // Any transport, e.g. a local fixture server or recorded responses
+    ApiManager(std::unique_ptr<Transport> transport, const std::string& url);
+
     nlohmann::json Search(const std::string& from, const std::string& to,
                           const std::string& date);
+    // Raw response body, for caching. Safe to call from several threads
+    // at once if the transport is
+    bool Fetch(const std::string& from, const std::string& to,
+               const std::string& date, std::string& body);
 
    private:
     const std::string api_key_ = "6b43fa85-ea9d-45a3-b2ce-640e6523d827";
     const std::string url = "https://api.rasp.yandex.net/v3.0/search/";
+    std::unique_ptr<Transport> transport_;
 };
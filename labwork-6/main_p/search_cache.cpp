@@ -0,0 +1,118 @@
+#include "search_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+#include "../save_algo/route_parser.h"
+
+namespace {
+
+std::string MakeKey(const SearchQuery& query) {
+    return query.from + '\t' + query.to + '\t' + query.date;
+}
+
+}  // namespace
+
+SearchCache::SearchCache(ApiManager& api_manager, const std::string& path,
+                         int64_t ttl_seconds)
+    : api_manager_(api_manager),
+      disk_(path, ttl_seconds),
+      ttl_seconds_(ttl_seconds) {}
+
+SearchResult SearchCache::Search(const std::string& from,
+                                 const std::string& to,
+                                 const std::string& date) {
+    return SearchAll({{from, to, date}}, 1)[0];
+}
+
+std::vector<SearchResult> SearchCache::SearchAll(
+    const std::vector<SearchQuery>& queries, size_t max_in_flight) {
+    std::vector<SearchResult> results(queries.size());
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (!Lookup(queries[i], results[i])) {
+            misses.push_back(i);
+        }
+    }
+
+    std::vector<std::string> bodies(misses.size());
+    std::vector<char> fetched(misses.size(), false);
+    std::atomic<size_t> next{0};
+    auto fetch = [&] {
+        for (size_t j = next++; j < misses.size(); j = next++) {
+            const SearchQuery& query = queries[misses[j]];
+            fetched[j] = api_manager_.Fetch(query.from, query.to, query.date,
+                                            bodies[j]);
+        }
+    };
+    // The calling thread is one of the workers
+    size_t workers = std::min(std::max<size_t>(max_in_flight, 1),
+                              misses.size());
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; ++w) {
+        pool.emplace_back(fetch);
+    }
+    fetch();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    for (size_t j = 0; j < misses.size(); ++j) {
+        if (fetched[j]) {
+            results[misses[j]] = Store(queries[misses[j]], bodies[j]);
+        }
+    }
+    return results;
+}
+
+bool SearchCache::Lookup(const SearchQuery& query, SearchResult& result) {
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    std::string key = MakeKey(query);
+    auto it = memory_.find(key);
+    if (it != memory_.end()) {
+        if (ttl_seconds_ <= 0 || now - it->second.stored_at < ttl_seconds_) {
+            std::cout << "Found in cache\n";
+            result = {true, true, it->second.routes};
+            return true;
+        }
+        memory_.erase(it);
+    }
+
+    std::string body;
+    int64_t stored_at = now;
+    if (!disk_.Get(query.from, query.to, query.date, body, &stored_at)) {
+        return false;
+    }
+    ParseStatus status = ParseRoutes(body, result.routes);
+    if (status == ParseStatus::kInvalidJson) {
+        return false;
+    }
+    std::cout << "Found in cache\n";
+    result.found = true;
+    result.has_segments = status == ParseStatus::kOk;
+    if (result.has_segments) {
+        memory_[key] = {result.routes, stored_at};
+    }
+    return true;
+}
+
+SearchResult SearchCache::Store(const SearchQuery& query,
+                                const std::string& body) {
+    SearchResult result;
+    ParseStatus status = ParseRoutes(body, result.routes);
+    if (status == ParseStatus::kInvalidJson) {
+        std::cerr << "Invalid JSON response\n";
+        return result;
+    }
+    result.found = true;
+    result.has_segments = status == ParseStatus::kOk;
+    if (result.has_segments) {
+        disk_.Put(query.from, query.to, query.date, body);
+        memory_[MakeKey(query)] = {
+            result.routes, static_cast<int64_t>(std::time(nullptr))};
+    }
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../cache/route_cache.h"
+#include "../save_algo/save_route.h"
+#include "api_manager.h"
+
+struct SearchQuery {
+    std::string from;
+    std::string to;
+    std::string date;
+};
+
+struct SearchResult {
+    bool found = false;  // From a cache or the API
+    bool has_segments = false;
+    std::vector<Route> routes;
+};
+
+// Search with two cache levels in front of the API: parsed routes of this
+// run in memory, raw responses of earlier runs in a RouteCache file.
+// Both expire after the TTL; only responses with routes are kept, so a
+// repeated search within the TTL never reaches ApiManager
+class SearchCache {
+   public:
+    // ttl_seconds 0 - responses never expire
+    SearchCache(ApiManager& api_manager, const std::string& path,
+                int64_t ttl_seconds);
+
+    SearchResult Search(const std::string& from, const std::string& to,
+                        const std::string& date);
+    // Results in the order of the queries. Cache misses are fetched by
+    // up to max_in_flight threads at once; the caches are only touched
+    // from the calling thread
+    std::vector<SearchResult> SearchAll(
+        const std::vector<SearchQuery>& queries, size_t max_in_flight);
+
+   private:
+    struct Entry {
+        std::vector<Route> routes;
+        int64_t stored_at;
+    };
+
+    ApiManager& api_manager_;
+    RouteCache disk_;
+    int64_t ttl_seconds_;
+    std::unordered_map<std::string, Entry> memory_;
+
+    bool Lookup(const SearchQuery& query, SearchResult& result);
+    SearchResult Store(const SearchQuery& query, const std::string& body);
+};
@@ -0,0 +1,57 @@
+#include "transport.h"
+
+#include <cpr/cpr.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+HttpTransport::HttpTransport(int timeout_ms) : timeout_ms_(timeout_ms) {}
+
+bool HttpTransport::Get(const std::string& url,
+                        const QueryParameters& parameters, std::string& body) {
+    cpr::Parameters cpr_parameters;
+    for (const auto& [key, value] : parameters) {
+        cpr_parameters.Add({key, value});
+    }
+    cpr::Response r = cpr::Get(cpr::Url{url}, cpr_parameters,
+                               cpr::Timeout{timeout_ms_});
+
+    if (r.status_code != 200) {
+        std::cerr << "HTTP Error: " << r.status_code << "\n";
+        std::cerr << "Error message: " << r.error.message << "\n";
+        return false;
+    }
+    body = std::move(r.text);
+    return true;
+}
+
+DirectoryTransport::DirectoryTransport(const std::string& directory)
+    : directory_(directory) {}
+
+bool DirectoryTransport::Get(const std::string& /*url*/,
+                             const QueryParameters& parameters,
+                             std::string& body) {
+    std::string from, to, date;
+    for (const auto& [key, value] : parameters) {
+        if (key == "from") {
+            from = value;
+        } else if (key == "to") {
+            to = value;
+        } else if (key == "date") {
+            date = value;
+        }
+    }
+
+    std::string path =
+        directory_ + "/" + from + "_" + to + "_" + date + ".json";
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "No recorded response: " << path << "\n";
+        return false;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    body = content.str();
+    return true;
+}
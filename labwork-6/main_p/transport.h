@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using QueryParameters = std::vector<std::pair<std::string, std::string>>;
+
+// Where ApiManager gets raw responses from. HttpTransport talks to the
+// live API or to a local fixture server, DirectoryTransport replays
+// recorded JSON, so tests and benchmarks can run without the network
+class Transport {
+   public:
+    virtual ~Transport() = default;
+
+    // Body of a successful response; false with the reason on stderr.
+    // Called concurrently by SearchCache::SearchAll
+    virtual bool Get(const std::string& url,
+                     const QueryParameters& parameters, std::string& body) = 0;
+};
+
+class HttpTransport : public Transport {
+   public:
+    explicit HttpTransport(int timeout_ms = 30000);
+
+    bool Get(const std::string& url, const QueryParameters& parameters,
+             std::string& body) override;
+
+   private:
+    int timeout_ms_;
+};
+
+// <directory>/<from>_<to>_<date>.json for the parameters of that name;
+// the url is ignored
+class DirectoryTransport : public Transport {
+   public:
+    explicit DirectoryTransport(const std::string& directory);
+
+    bool Get(const std::string& url, const QueryParameters& parameters,
+             std::string& body) override;
+
+   private:
+    std::string directory_;
+};
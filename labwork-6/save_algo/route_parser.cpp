@@ -0,0 +1,461 @@
+#include "route_parser.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+enum class Key {
+    kOther,
+    kSegments,
+    kHasTransfers,
+    kIsTransfer,
+    kDepartureFrom,
+    kArrivalTo,
+    kFrom,
+    kTo,
+    kDeparture,
+    kArrival,
+    kThread,
+    kTitle,
+    kPopularTitle,
+    kShortTitle,
+    kNumber,
+    kTransportType,
+    kTransfers,
+    kDetails,
+    kTicketsInfo,
+    kPlaces,
+    kPrice,
+    kWhole,
+};
+
+Key ToKey(const std::string& name) {
+    static const std::unordered_map<std::string, Key> keys = {
+        {"segments", Key::kSegments},
+        {"has_transfers", Key::kHasTransfers},
+        {"is_transfer", Key::kIsTransfer},
+        {"departure_from", Key::kDepartureFrom},
+        {"arrival_to", Key::kArrivalTo},
+        {"from", Key::kFrom},
+        {"to", Key::kTo},
+        {"departure", Key::kDeparture},
+        {"arrival", Key::kArrival},
+        {"thread", Key::kThread},
+        {"title", Key::kTitle},
+        {"popular_title", Key::kPopularTitle},
+        {"short_title", Key::kShortTitle},
+        {"number", Key::kNumber},
+        {"transport_type", Key::kTransportType},
+        {"transfers", Key::kTransfers},
+        {"details", Key::kDetails},
+        {"tickets_info", Key::kTicketsInfo},
+        {"places", Key::kPlaces},
+        {"price", Key::kPrice},
+        {"whole", Key::kWhole},
+    };
+    auto it = keys.find(name);
+    return it == keys.end() ? Key::kOther : it->second;
+}
+
+// Title fields of a station object, as GetStationName picks them
+struct Station {
+    bool present = false;  // The key was there, whatever its value
+    bool has_title = false;
+    bool has_popular_title = false;
+    bool has_short_title = false;
+    std::string title;
+    std::string popular_title;
+    std::string short_title;
+
+    void Set(Key key, std::string& value) {
+        if (key == Key::kTitle) {
+            has_title = true;
+            title = std::move(value);
+        } else if (key == Key::kPopularTitle) {
+            has_popular_title = true;
+            popular_title = std::move(value);
+        } else if (key == Key::kShortTitle) {
+            has_short_title = true;
+            short_title = std::move(value);
+        }
+    }
+
+    std::string Name() const {
+        return has_title           ? title
+               : has_popular_title ? popular_title
+               : has_short_title   ? short_title
+                                   : "Unknown";
+    }
+};
+
+// Fields of a segment or of one of its details
+struct Part {
+    Station self;  // Title fields of the part itself
+    Station from;
+    Station to;
+    Station departure_from;
+    Station arrival_to;
+    std::string departure = "Unknown";
+    std::string arrival = "Unknown";
+    bool has_thread_title = false;
+    bool has_thread_number = false;
+    bool has_transport_type = false;
+    std::string thread_title;
+    std::string thread_number;
+    std::string transport_type;
+    bool has_transfers = false;
+    bool is_transfer = false;
+    int transfer_count = 0;
+    int price = 0;
+    // Lines of the non-transfer details, for a route with transfers
+    std::string details = "Route with transfers:\n";
+    int details_price = 0;
+    int detail_count = 0;
+};
+
+enum class Role {
+    kRoot,
+    kSegmentList,
+    kSegment,
+    kDetailList,
+    kDetail,
+    kStation,
+    kThread,
+    kTransfers,
+    kTicketsInfo,
+    kPlaces,
+    kFirstPlace,
+    kPrice,
+    kIgnored,
+};
+
+struct Frame {
+    Role role;
+    bool array;
+    Part* part;
+    Station* station;
+    Key key = Key::kOther;  // Of the current member of an object
+    size_t count = 0;       // Members or elements so far
+};
+
+class RouteHandler : public nlohmann::json_sax<json> {
+   public:
+    explicit RouteHandler(std::vector<Route>& routes) : routes_(routes) {}
+
+    bool HasSegments() const { return has_segments_; }
+
+    bool null() override {
+        Scalar(false);
+        return true;
+    }
+
+    bool boolean(bool value) override {
+        Frame* parent = Scalar(true);
+        if (parent && IsPart(parent->role)) {
+            if (parent->key == Key::kHasTransfers) {
+                parent->part->has_transfers = value;
+            } else if (parent->key == Key::kIsTransfer) {
+                parent->part->is_transfer = value;
+            }
+        }
+        return true;
+    }
+
+    bool number_integer(number_integer_t value) override {
+        Price(Scalar(true), static_cast<int>(value));
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t value) override {
+        Price(Scalar(true), static_cast<int>(value));
+        return true;
+    }
+
+    bool number_float(number_float_t value, const string_t&) override {
+        Price(Scalar(true), static_cast<int>(value));
+        return true;
+    }
+
+    bool string(string_t& value) override {
+        Frame* parent = Scalar(true);
+        if (!parent) {
+            return true;
+        }
+        Part& part = *parent->part;
+        switch (parent->role) {
+        case Role::kSegment:
+        case Role::kDetail:
+            if (parent->key == Key::kDeparture) {
+                part.departure = std::move(value);
+            } else if (parent->key == Key::kArrival) {
+                part.arrival = std::move(value);
+            } else {
+                part.self.Set(parent->key, value);
+            }
+            break;
+        case Role::kStation:
+            parent->station->Set(parent->key, value);
+            break;
+        case Role::kThread:
+            if (parent->key == Key::kTitle) {
+                part.has_thread_title = true;
+                part.thread_title = std::move(value);
+            } else if (parent->key == Key::kNumber) {
+                part.has_thread_number = true;
+                part.thread_number = std::move(value);
+            } else if (parent->key == Key::kTransportType) {
+                part.has_transport_type = true;
+                part.transport_type = std::move(value);
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override {
+        Scalar(true);
+        return true;
+    }
+
+    bool start_object(size_t) override {
+        Open(true);
+        return true;
+    }
+
+    bool key(string_t& name) override {
+        Frame& frame = stack_.back();
+        ++frame.count;
+        frame.key = frame.role == Role::kIgnored ? Key::kOther : ToKey(name);
+        if (frame.role == Role::kRoot && frame.key == Key::kSegments) {
+            has_segments_ = true;
+        } else if (IsPart(frame.role)) {
+            if (Station* station = PartStation(*frame.part, frame.key)) {
+                station->present = true;
+            }
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        Close();
+        return true;
+    }
+
+    bool start_array(size_t) override {
+        Open(false);
+        return true;
+    }
+
+    bool end_array() override {
+        Close();
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string&,
+                     const nlohmann::detail::exception&) override {
+        return false;
+    }
+
+   private:
+    std::vector<Route>& routes_;
+    std::vector<Frame> stack_;
+    Part segment_;
+    Part detail_;
+    bool has_segments_ = false;
+
+    static bool IsPart(Role role) {
+        return role == Role::kSegment || role == Role::kDetail;
+    }
+
+    static Station* PartStation(Part& part, Key key) {
+        switch (key) {
+        case Key::kFrom:
+            return &part.from;
+        case Key::kTo:
+            return &part.to;
+        case Key::kDepartureFrom:
+            return &part.departure_from;
+        case Key::kArrivalTo:
+            return &part.arrival_to;
+        default:
+            return nullptr;
+        }
+    }
+
+    // Counts the value in its parent array and returns the parent
+    Frame* Place() {
+        if (stack_.empty()) {
+            return nullptr;
+        }
+        Frame& parent = stack_.back();
+        if (parent.array) {
+            ++parent.count;
+        }
+        return &parent;
+    }
+
+    // A scalar "transfers" has size 1, null has size 0, as in json::size
+    Frame* Scalar(bool not_null) {
+        Frame* parent = Place();
+        if (parent && IsPart(parent->role) &&
+            parent->key == Key::kTransfers) {
+            parent->part->transfer_count = not_null ? 1 : 0;
+        }
+        return parent;
+    }
+
+    void Price(Frame* parent, int value) {
+        if (parent && parent->role == Role::kPrice &&
+            parent->key == Key::kWhole) {
+            parent->part->price = value;
+        }
+    }
+
+    void Open(bool object) {
+        Frame* parent = Place();
+        Frame frame{Role::kIgnored, !object, parent ? parent->part : nullptr,
+                    nullptr};
+        if (!parent) {
+            frame.role = object ? Role::kRoot : Role::kIgnored;
+        } else {
+            frame.role = ChildRole(*parent, object, frame);
+        }
+        if (frame.role == Role::kSegment) {
+            segment_ = Part();
+            frame.part = &segment_;
+        } else if (frame.role == Role::kDetail) {
+            detail_ = Part();
+            frame.part = &detail_;
+        }
+        stack_.push_back(frame);
+    }
+
+    void Close() {
+        const Frame& frame = stack_.back();
+        if (frame.role == Role::kTransfers) {
+            frame.part->transfer_count = static_cast<int>(frame.count);
+        }
+        Role role = frame.role;
+        stack_.pop_back();
+        if (role == Role::kDetail) {
+            AddDetail();
+        } else if (role == Role::kSegment) {
+            AddSegment();
+        }
+    }
+
+    Role ChildRole(const Frame& parent, bool object, Frame& frame) {
+        switch (parent.role) {
+        case Role::kRoot:
+            return parent.key == Key::kSegments && !object ? Role::kSegmentList
+                                                           : Role::kIgnored;
+        case Role::kSegmentList:
+            return object ? Role::kSegment : Role::kIgnored;
+        case Role::kDetailList:
+            return object ? Role::kDetail : Role::kIgnored;
+        case Role::kSegment:
+        case Role::kDetail:
+            return PartChildRole(parent, object, frame);
+        case Role::kTicketsInfo:
+            return parent.key == Key::kPlaces && !object ? Role::kPlaces
+                                                         : Role::kIgnored;
+        case Role::kPlaces:
+            return parent.count == 1 && object ? Role::kFirstPlace
+                                               : Role::kIgnored;
+        case Role::kFirstPlace:
+            return parent.key == Key::kPrice && object ? Role::kPrice
+                                                       : Role::kIgnored;
+        default:
+            return Role::kIgnored;
+        }
+    }
+
+    Role PartChildRole(const Frame& parent, bool object, Frame& frame) {
+        if (Station* station = PartStation(*parent.part, parent.key)) {
+            frame.station = station;
+            return object ? Role::kStation : Role::kIgnored;
+        }
+        switch (parent.key) {
+        case Key::kThread:
+            return object ? Role::kThread : Role::kIgnored;
+        case Key::kTransfers:
+            return Role::kTransfers;
+        case Key::kTicketsInfo:
+            return object ? Role::kTicketsInfo : Role::kIgnored;
+        case Key::kDetails:
+            return parent.role == Role::kSegment && !object
+                       ? Role::kDetailList
+                       : Role::kIgnored;
+        default:
+            return Role::kIgnored;
+        }
+    }
+
+    void AddDetail() {
+        const Part& detail = detail_;
+        if (detail.is_transfer || !detail.has_transport_type ||
+            !detail.from.present || !detail.to.present) {
+            return;
+        }
+        segment_.details += std::to_string(++segment_.detail_count) + ". " +
+                            detail.transport_type + " " + detail.from.Name() +
+                            " — " + detail.to.Name() + " (" +
+                            detail.departure + " -> " + detail.arrival +
+                            ")\n";
+        segment_.details_price += detail.price;
+    }
+
+    void AddSegment() {
+        Part& segment = segment_;
+        Route route;
+        if (segment.has_transfers) {
+            route.from = segment.departure_from.present
+                             ? segment.departure_from.Name()
+                             : "";
+            route.to =
+                segment.arrival_to.present ? segment.arrival_to.Name() : "";
+            route.departure = std::move(segment.departure);
+            route.arrival = std::move(segment.arrival);
+            route.transport_type = "Combined";
+            route.is_transfer = true;
+            route.transfer_count = segment.transfer_count;
+            route.thread_title = std::move(segment.details);
+            route.price = segment.details_price;
+        } else {
+            route.from = segment.from.present ? segment.from.Name()
+                                              : segment.self.Name();
+            route.to = segment.to.present ? segment.to.Name()
+                                          : segment.self.Name();
+            route.departure = std::move(segment.departure);
+            route.arrival = std::move(segment.arrival);
+            route.thread_title = segment.has_thread_title
+                                     ? std::move(segment.thread_title)
+                                     : "Unknown";
+            route.thread_number = segment.has_thread_number
+                                      ? std::move(segment.thread_number)
+                                      : "Unknown";
+            route.transport_type = segment.has_transport_type
+                                       ? std::move(segment.transport_type)
+                                       : "Unknown";
+            route.is_transfer = false;
+            route.price = segment.price;
+            route.transfer_count = 0;
+        }
+        routes_.push_back(std::move(route));
+    }
+};
+
+}  // namespace
+
+ParseStatus ParseRoutes(std::string_view body, std::vector<Route>& routes) {
+    routes.clear();
+    RouteHandler handler(routes);
+    if (!json::sax_parse(body.begin(), body.end(), &handler)) {
+        routes.clear();
+        return ParseStatus::kInvalidJson;
+    }
+    return handler.HasSegments() ? ParseStatus::kOk : ParseStatus::kNoSegments;
+}
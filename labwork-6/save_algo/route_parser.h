@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "save_route.h"
+
+// What ParseRoutes found in a response body
+enum class ParseStatus { kOk, kInvalidJson, kNoSegments };
+
+// The routes ParseJson(json::parse(body)) gives, read straight from the
+// text by a SAX handler: no DOM is built, only the fields a Route uses are
+// kept and their strings are moved out of the parser
+ParseStatus ParseRoutes(std::string_view body, std::vector<Route>& routes);
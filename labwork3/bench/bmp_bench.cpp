@@ -0,0 +1,91 @@
+/*
+Замер кодирования и записи BMP: построчный кодировщик против
+попиксельного (Get + put на каждый байт).
+
+    ./bmp_bench [размер сетки] [путь для временного файла]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "../bmp/bmp_writer.h"
+#include "../matrix/matrix.h"
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+/* Прежняя схема записи: проверка границ и put на каждый байт */
+void WritePerPixel(const char *filename, const DynamicMatrix &matrix) {
+    int width = matrix.GetWidth();
+    int height = matrix.GetHeight();
+    int min_x = matrix.GetMinX();
+    int min_y = matrix.GetMinY();
+    int row_size = BMPRowSize(width);
+
+    std::ofstream output_file(filename, std::ios::out | std::ios::binary);
+    for (int i = 0; i < 54 + 16 * 4; ++i) {
+        output_file.put(0);
+    }
+    for (int y = height - 1; y >= 0; --y) {
+        for (int x = 0; x < width; x += 2) {
+            uint64_t pixel1 = matrix.Get(x + min_x, y + min_y);
+            uint64_t pixel2 =
+                (x + 1 < width) ? matrix.Get(x + 1 + min_x, y + min_y) : 0;
+            pixel1 = (pixel1 > 3) ? 4 : pixel1;
+            pixel2 = (pixel2 > 3) ? 4 : pixel2;
+            output_file.put(static_cast<char>((pixel1 << 4) | pixel2));
+        }
+        for (int p = 0; p < row_size - (width + 1) / 2; ++p) {
+            output_file.put(0);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int size = argc > 1 ? std::atoi(argv[1]) : 8192;
+    const char *path = argc > 2 ? argv[2] : "bmp_bench.bmp";
+
+    DynamicMatrix matrix(size, size);
+    srand(42);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            matrix.Set(x, y, rand() % 6);
+        }
+    }
+    double megapixels = static_cast<double>(size) * size / 1e6;
+    std::cout << "grid " << size << "x" << size << std::endl;
+
+    uint8_t *pixels =
+        new uint8_t[static_cast<size_t>(BMPRowSize(size)) * size];
+    auto start = std::chrono::steady_clock::now();
+    EncodeBMPImage(matrix, pixels);
+    double encode = SecondsSince(start);
+    std::cout << "encode rows\t" << encode * 1000 << " ms\t"
+              << megapixels / encode << " Mpixel/s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    WriteBMPImage(path, size, size, pixels);
+    double write = SecondsSince(start);
+    std::cout << "write image\t" << write * 1000 << " ms" << std::endl;
+    delete[] pixels;
+
+    start = std::chrono::steady_clock::now();
+    WritePerPixel(path, matrix);
+    double per_pixel = SecondsSince(start);
+    std::cout << "per-pixel\t" << per_pixel * 1000 << " ms\t"
+              << megapixels / per_pixel << " Mpixel/s" << std::endl;
+
+    std::remove(path);
+    return 0;
+}
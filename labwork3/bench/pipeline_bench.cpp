@@ -0,0 +1,187 @@
+/*
+Замер всего конвейера по фазам: загрузка TSV, расширение сетки, шаги
+осыпания, проверка устойчивости и запись BMP. Для каждой
+нагрузки печатает время фаз, скорость в клетках за секунду, пиковую
+память процесса и число перевыделений сетки.
+
+    ./pipeline_bench <tall|noise|sparse> [масштаб] [шагов] [частота BMP]
+
+    tall   - одна высокая куча в начале координат, масштаб - песчинки
+    noise  - квадрат со случайными 0..7 песчинками, масштаб - сторона
+    sparse - четыре далёкие кучи на разреженной сетке, масштаб - песчинки
+             в каждой куче
+
+Каждая нагрузка запускается отдельным процессом, чтобы пиковая память
+относилась только к ней. Файлы нагрузки называются по ней
+(pipeline_<нагрузка>.tsv/.bmp), так что разные нагрузки можно гонять
+параллельно в одном каталоге.
+*/
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "../bmp/bmp_writer.h"
+#include "../matrix/matrix.h"
+#include "../matrix/tiled_matrix.h"
+#include "../parser-tsv/tsv_loader.h"
+#include "../sandpile/sandpile.h"
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+/* Пиковая резидентная память процесса в мегабайтах */
+double PeakRSSMegabytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;  // ru_maxrss в килобайтах
+}
+
+/* Входной файл нагрузки; false, если нагрузка неизвестна */
+bool GenerateWorkload(const char *workload, int64_t scale,
+                      const std::string &path) {
+    std::ofstream output(path);
+    if (std::strcmp(workload, "tall") == 0) {
+        output << "0 0 " << scale << '\n';
+    } else if (std::strcmp(workload, "noise") == 0) {
+        srand(42);
+        for (int y = 0; y < scale; ++y) {
+            for (int x = 0; x < scale; ++x) {
+                output << x << ' ' << y << ' ' << rand() % 8 << '\n';
+            }
+        }
+    } else if (std::strcmp(workload, "sparse") == 0) {
+        const int kDistance = 4000;
+        output << -kDistance << ' ' << -kDistance << ' ' << scale << '\n';
+        output << kDistance << ' ' << -kDistance << ' ' << scale << '\n';
+        output << -kDistance << ' ' << kDistance << ' ' << scale << '\n';
+        output << kDistance << ' ' << kDistance << ' ' << scale << '\n';
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/* Сколько клеток обрабатывает один шаг */
+int64_t CellsPerStep(const DynamicMatrix &matrix) {
+    return static_cast<int64_t>(matrix.GetWidth()) * matrix.GetHeight();
+}
+
+int64_t CellsPerStep(const TiledMatrix &matrix) {
+    return static_cast<int64_t>(matrix.GetTileCount()) *
+           TiledMatrix::kTileCells;
+}
+
+int GrowthCount(const DynamicMatrix &matrix) {
+    return matrix.GetGrowthCount();
+}
+
+int GrowthCount(const TiledMatrix &matrix) { return matrix.GetTileCount(); }
+
+template <typename Matrix>
+bool RunPipeline(const char *workload, const std::string &input_path,
+                 const std::string &bmp_path, int max_steps, int bmp_freq) {
+    double load = 0, expand = 0, topple = 0, stable = 0, bmp = 0;
+    int64_t cell_updates = 0;
+    int steps = 0;
+    bool stabilized = false;
+
+    auto start = std::chrono::steady_clock::now();
+    TSVLoader loader;
+    if (!loader.Load(input_path.c_str())) {
+        return false;
+    }
+    Matrix matrix;
+    loader.Fill(matrix);
+    load = SecondsSince(start);
+
+    Sandpile sandpile(matrix);
+    while (steps < max_steps && !stabilized) {
+        start = std::chrono::steady_clock::now();
+        sandpile.Expand();
+        expand += SecondsSince(start);
+
+        cell_updates += CellsPerStep(matrix);
+        start = std::chrono::steady_clock::now();
+        sandpile.Step();
+        topple += SecondsSince(start);
+
+        if (bmp_freq > 0 && steps % bmp_freq == 0) {
+            start = std::chrono::steady_clock::now();
+            WriteBMP(bmp_path.c_str(), matrix);
+            bmp += SecondsSince(start);
+        }
+
+        start = std::chrono::steady_clock::now();
+        stabilized = sandpile.IsStable();
+        stable += SecondsSince(start);
+        ++steps;
+    }
+
+    std::cout << "workload\t" << workload << "\n"
+              << "steps\t" << steps << (stabilized ? " (stable)" : "")
+              << "\n"
+              << "grid\t" << matrix.GetWidth() << "x" << matrix.GetHeight()
+              << "\n"
+              << "load\t" << load * 1000 << " ms\n"
+              << "expand\t" << expand * 1000 << " ms\n"
+              << "topple\t" << topple * 1000 << " ms\t"
+              << cell_updates / topple / 1e6 << " Mcell-updates/s\n"
+              << "stable\t" << stable * 1000 << " ms\n"
+              << "bmp\t" << bmp * 1000 << " ms\n"
+              << "growths\t" << GrowthCount(matrix)
+              << (std::is_same<Matrix, TiledMatrix>::value ? " tiles" : "")
+              << "\n"
+              << "peak rss\t" << PeakRSSMegabytes() << " MB" << std::endl;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: pipeline_bench <tall|noise|sparse> [scale] "
+                     "[steps] [bmp freq]"
+                  << std::endl;
+        return 1;
+    }
+    const char *workload = argv[1];
+    bool sparse = std::strcmp(workload, "sparse") == 0;
+    int64_t default_scale = std::strcmp(workload, "noise") == 0 ? 1024
+                            : sparse                           ? 100000
+                                                               : 1 << 20;
+    int64_t scale = argc > 2 ? std::atoll(argv[2]) : default_scale;
+    int max_steps = argc > 3 ? std::atoi(argv[3]) : 1000000000;
+    int bmp_freq = argc > 4 ? std::atoi(argv[4]) : 1000;
+
+    std::string base = std::string("pipeline_") + workload;
+    std::string input_path = base + ".tsv";
+    std::string bmp_path = base + ".bmp";
+    if (!GenerateWorkload(workload, scale, input_path)) {
+        std::cerr << "Unknown workload: " << workload << std::endl;
+        std::remove(input_path.c_str());
+        return 1;
+    }
+    bool finished =
+        sparse ? RunPipeline<TiledMatrix>(workload, input_path, bmp_path,
+                                          max_steps, bmp_freq)
+               : RunPipeline<DynamicMatrix>(workload, input_path, bmp_path,
+                                            max_steps, bmp_freq);
+
+    std::remove(input_path.c_str());
+    std::remove(bmp_path.c_str());
+    return finished ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*
+Замер скорости шага осыпания: клеток в секунду для каждой ширины клетки
+и каждой реализации ядра.
+
+    ./stencil_bench [размер сетки] [количество шагов]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "../matrix/matrix.h"
+#include "../sandpile/sandpile.h"
+#include "../stencil/stencil.h"
+
+namespace {
+
+const char *CellWidthName(CellWidth width) {
+    switch (width) {
+        case CellWidth::k16:
+            return "uint16";
+        case CellWidth::k32:
+            return "uint32";
+        default:
+            return "uint64";
+    }
+}
+
+/* Одна куча в центре квадратной сетки; количество песчинок выбирает
+   ширину клетки */
+void RunCase(StencilBackend backend, uint64_t grains, int size, int steps) {
+    SetStencilBackend(backend);
+
+    DynamicMatrix matrix(size, size);
+    matrix.Set(size / 2, size / 2, grains);
+    Sandpile sandpile(matrix);
+
+    uint64_t cell_updates = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) {
+        cell_updates += static_cast<uint64_t>(matrix.GetWidth()) *
+                        matrix.GetHeight();
+        sandpile.Topple();
+    }
+    auto finish = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(finish - start).count();
+
+    std::cout << GetStencilBackendName() << "\t"
+              << CellWidthName(matrix.GetCellWidth()) << "\t" << steps
+              << " steps\t" << seconds * 1000 << " ms\t"
+              << cell_updates / seconds / 1e6 << " Mcell-updates/s"
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int size = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    const uint64_t piles[] = {UINT16_MAX, UINT32_MAX, UINT64_MAX >> 2};
+    const StencilBackend backends[] = {StencilBackend::kScalar,
+                                       StencilBackend::kAVX2};
+
+    std::cout << "grid " << size << "x" << size << std::endl;
+    for (uint64_t grains : piles) {
+        for (StencilBackend backend : backends) {
+            RunCase(backend, grains, size, steps);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+Замер загрузки начального состояния: построчное чтение через getline и
+ParsTSVFile с расширением сетки по одной клетке против TSVLoader.
+
+    ./tsv_bench [количество строк] [путь для временного файла]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "../matrix/matrix.h"
+#include "../parser-tsv/read-tsv.cpp"
+#include "../parser-tsv/tsv_loader.h"
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int lines = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const char *path = argc > 2 ? argv[2] : "tsv_bench.tsv";
+
+    /* Клетки разбросаны по квадрату вокруг начала координат */
+    int side = 1;
+    while (static_cast<int64_t>(side) * side < lines) {
+        side *= 2;
+    }
+    {
+        std::ofstream output(path);
+        srand(42);
+        for (int i = 0; i < lines; ++i) {
+            output << rand() % side - side / 2 << ' '
+                   << rand() % side - side / 2 << ' ' << rand() % 100
+                   << '\n';
+        }
+    }
+    std::cout << "lines " << lines << ", box " << side << "x" << side
+              << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    TSVLoader loader;
+    if (!loader.Load(path)) {
+        return 1;
+    }
+    double parse = SecondsSince(start);
+    DynamicMatrix loaded;
+    loader.Fill(loaded);
+    double bulk = SecondsSince(start);
+    std::cout << "loader\t" << bulk * 1000 << " ms (parse " << parse * 1000
+              << " ms)\tgrowths " << loaded.GetGrowthCount() << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    DynamicMatrix matrix;
+    std::ifstream input(path);
+    char buffer[512];
+    log_s logs;
+    while (input.getline(buffer, sizeof(buffer))) {
+        ParsTSVFile(buffer, logs);
+        matrix.AddGrains(logs.width, logs.height, logs.count);
+    }
+    double line_by_line = SecondsSince(start);
+    std::cout << "getline\t" << line_by_line * 1000 << " ms\tgrowths "
+              << matrix.GetGrowthCount() << std::endl;
+
+    /* Обе загрузки должны дать одну и ту же сетку */
+    bool same = matrix.GetWidth() == loaded.GetWidth() &&
+                matrix.GetHeight() == loaded.GetHeight();
+    for (int y = matrix.GetMinY(); same && y < matrix.GetMinY() +
+                                                   matrix.GetHeight();
+         ++y) {
+        for (int x = matrix.GetMinX();
+             x < matrix.GetMinX() + matrix.GetWidth(); ++x) {
+            if (matrix.Get(x, y) != loaded.Get(x, y)) {
+                same = false;
+                break;
+            }
+        }
+    }
+    std::cout << (same ? "grids match" : "grids differ") << std::endl;
+
+    std::remove(path);
+    return same ? 0 : 1;
+}
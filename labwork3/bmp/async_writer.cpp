@@ -0,0 +1,117 @@
+#include "../bmp/async_writer.h"
+
+#include <cstdio>
+#include <iostream>
+
+#include "../bmp/bmp_writer.h"
+#include "../frames/frame_container.h"
+
+AsyncBMPWriter::AsyncBMPWriter(int queue_size)
+    : slots(new Slot[queue_size]),
+      container(nullptr),
+      queue_size(queue_size),
+      head(0),
+      count(0),
+      written(0),
+      writing(false),
+      stopping(false),
+      worker(&AsyncBMPWriter::Run, this) {}
+
+AsyncBMPWriter::~AsyncBMPWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    has_work.notify_one();
+    worker.join();
+    delete[] slots;
+}
+
+/* Снимок копируется в свободный слот; слот принадлежит симуляции, пока
+   не увеличен count, поэтому копирование идёт без блокировки */
+void AsyncBMPWriter::Submit(const char *filename,
+                            const DynamicMatrix &matrix, int iteration) {
+    Slot &slot = slots[AcquireSlot()];
+    std::snprintf(slot.filename, kMaxFilename, "%s", filename);
+    slot.iteration = iteration;
+    slot.sparse = false;
+    slot.snapshot.CopyFrom(matrix);
+    Publish();
+}
+
+void AsyncBMPWriter::Submit(const char *filename, const TiledMatrix &matrix,
+                            int iteration) {
+    Slot &slot = slots[AcquireSlot()];
+    std::snprintf(slot.filename, kMaxFilename, "%s", filename);
+    slot.iteration = iteration;
+    slot.sparse = true;
+    slot.sparse_snapshot.CopyFrom(matrix);
+    Publish();
+}
+
+int AsyncBMPWriter::AcquireSlot() {
+    std::unique_lock<std::mutex> lock(mutex);
+    has_space.wait(lock, [this] { return count < queue_size; });
+    return (head + count) % queue_size;
+}
+
+void AsyncBMPWriter::Publish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++count;
+    }
+    has_work.notify_one();
+}
+
+void AsyncBMPWriter::Flush() {
+    int files;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        has_space.wait(lock, [this] { return count == 0 && !writing; });
+        files = written;
+        written = 0;
+    }
+    if (files > 0) {
+        std::cout << "BMP files successfully written: " << files << "\n";
+    }
+}
+
+void AsyncBMPWriter::SetContainer(FrameContainer *frame_container) {
+    Flush();
+    container = frame_container;
+}
+
+void AsyncBMPWriter::Run() {
+    while (true) {
+        int current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            has_work.wait(lock, [this] { return count > 0 || stopping; });
+            if (count == 0) {
+                return;
+            }
+            current = head;
+            writing = true;
+        }
+
+        Slot &slot = slots[current];
+        bool file_written = false;
+        if (slot.sparse) {
+            file_written = WriteBMP(slot.filename, slot.sparse_snapshot);
+        } else if (container != nullptr) {
+            container->Append(static_cast<uint32_t>(slot.iteration),
+                              slot.snapshot);
+        } else {
+            file_written = WriteBMP(slot.filename, slot.snapshot);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            written += file_written ? 1 : 0;
+            head = (head + 1) % queue_size;
+            --count;
+            writing = false;
+        }
+        has_space.notify_all();
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "../matrix/matrix.h"
+#include "../matrix/tiled_matrix.h"
+
+class FrameContainer;
+
+/* Фоновая запись BMP: симуляция кладёт в очередь копию сетки,
+   кодирование и запись на диск выполняет отдельный поток.
+   Очередь ограничена: если все слоты заняты, Submit ждёт */
+class AsyncBMPWriter {
+   public:
+    explicit AsyncBMPWriter(int queue_size = 4);
+    ~AsyncBMPWriter();
+    AsyncBMPWriter(const AsyncBMPWriter &) = delete;
+    AsyncBMPWriter &operator=(const AsyncBMPWriter &) = delete;
+
+    void Submit(const char *filename, const DynamicMatrix &matrix,
+                int iteration = 0);
+    /* Разреженная сетка всегда пишется отдельными BMP-файлами */
+    void Submit(const char *filename, const TiledMatrix &matrix,
+                int iteration = 0);
+    /* Дождаться записи всех поставленных снимков и сообщить, сколько
+       записано с прошлого Flush: фоновый поток сам ничего не печатает */
+    void Flush();
+    /* Писать кадры в контейнер вместо отдельных BMP-файлов */
+    void SetContainer(FrameContainer *frame_container);
+
+   private:
+    static const int kMaxFilename = 256;
+
+    struct Slot {
+        char filename[kMaxFilename];
+        int iteration;
+        DynamicMatrix snapshot;
+        TiledMatrix sparse_snapshot;
+        bool sparse;  // Снимок лежит в sparse_snapshot
+    };
+
+    Slot *slots;
+    FrameContainer *container;
+    int queue_size;
+    int head;   // Следующий слот для записи на диск
+    int count;  // Сколько слотов ждут записи
+    int written;  // Записано с прошлого Flush
+    bool writing;
+    bool stopping;
+
+    std::mutex mutex;
+    std::condition_variable has_work;
+    std::condition_variable has_space;
+    std::thread worker;
+
+    int AcquireSlot();
+    void Publish();
+    void Run();
+};
+
+#endif  // ASYNC_WRITER_H
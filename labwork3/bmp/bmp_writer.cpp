@@ -1,26 +1,59 @@
 #include "../bmp/bmp_writer.h"
 #include "../matrix/matrix.h"
+#include "../matrix/tiled_matrix.h"
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
-void WriteBMP(const char *filename, const DynamicMatrix &matrix) {
-    int width = matrix.GetWidth();
-    int height = matrix.GetHeight();
-    int min_x = matrix.GetMinX();
-    int min_y = matrix.GetMinY();
-    int row_size = ((width + 1) / 2 + 3) & ~3;  // Размер строки, кратный 4
-    int image_size = row_size * height;
+namespace {
+
+/* Палитра: 0 - белый, 1 - зеленый, 2 - фиолетовый, 3 - желтый,
+   4 - черный (> 3), остальные цвета черные. Порядок байт BGRA */
+const uint8_t kPalette[16][4] = {
+    {255, 255, 255, 0},  // Белый
+    {0, 255, 0, 0},      // Зеленый
+    {128, 0, 128, 0},    // Фиолетовый
+    {0, 255, 255, 0},    // Желтый
+    {0, 0, 0, 0}         // Черный
+};
+
+/* Ограничение количества песчинок номером цвета: строка целиком,
+   цикл без ветвлений векторизуется компилятором */
+template <typename T>
+void ClampRowToPalette(const T *row, uint8_t *indices, int width) {
+    for (int x = 0; x < width; ++x) {
+        T value = row[x];
+        indices[x] = static_cast<uint8_t>(value < 4 ? value : 4);
+    }
+}
+
+/* Два пикселя на байт, левый пиксель в старших 4 битах */
+void PackNibbles(const uint8_t *indices, uint8_t *out, int width) {
+    int pairs = width / 2;
+    for (int i = 0; i < pairs; ++i) {
+        out[i] = static_cast<uint8_t>((indices[2 * i] << 4) |
+                                      indices[2 * i + 1]);
+    }
+    if (width % 2 != 0) {
+        out[pairs] = static_cast<uint8_t>(indices[width - 1] << 4);
+    }
+}
+
+/* Открытие файла и запись заголовков с палитрой одним блоком */
+bool OpenBMP(const char *filename, int width, int height,
+             std::ofstream &output_file) {
+    uint32_t image_size = static_cast<uint32_t>(BMPRowSize(width)) * height;
+    uint32_t header_size =
+        sizeof(BMP_file_header) + sizeof(BMP_info_header) + sizeof(kPalette);
 
     BMP_file_header file_header;
     BMP_info_header info_header;
 
     file_header.file_type = 0x4D42;  // "BM"
-    file_header.file_size =
-        sizeof(BMP_file_header) + sizeof(BMP_info_header) + 16 * 4 + image_size;
+    file_header.file_size = header_size + image_size;
     file_header.reserved1 = 0;
     file_header.reserved2 = 0;
-    file_header.offset_data =
-        sizeof(BMP_file_header) + sizeof(BMP_info_header) + 16 * 4;
+    file_header.offset_data = header_size;
 
     info_header.size = sizeof(BMP_info_header);
     info_header.width = width;
@@ -34,60 +67,152 @@ void WriteBMP(const char *filename, const DynamicMatrix &matrix) {
     info_header.colors_used = 5;
     info_header.colors_important = 0;
 
+    uint8_t header[sizeof(BMP_file_header) + sizeof(BMP_info_header) +
+                   sizeof(kPalette)];
+    std::memcpy(header, &file_header, sizeof(file_header));
+    std::memcpy(header + sizeof(file_header), &info_header,
+                sizeof(info_header));
+    std::memcpy(header + sizeof(file_header) + sizeof(info_header), kPalette,
+                sizeof(kPalette));
+
     // Открытие файла для записи
-    std::ofstream output_file(filename, std::ios::out | std::ios::binary);
+    output_file.open(filename, std::ios::out | std::ios::binary);
     if (!output_file.is_open()) {
         std::cerr << "File could not be opened" << std::endl;
-        return;
+        return false;
     }
+    output_file.write(reinterpret_cast<const char *>(header), header_size);
+    return true;
+}
+
+}  // namespace
+
+int BMPRowSize(int width) {
+    return ((width + 1) / 2 + 3) & ~3;  // Размер строки, кратный 4
+}
+
+void EncodeBMPImage(const DynamicMatrix &matrix, uint8_t *pixels) {
+    int width = matrix.GetWidth();
+    int height = matrix.GetHeight();
+    int row_size = BMPRowSize(width);
+    uint8_t *indices = new uint8_t[width];
 
-    output_file.write(reinterpret_cast<char *>(&file_header),
-                      sizeof(file_header));
-    output_file.write(reinterpret_cast<char *>(&info_header),
-                      sizeof(info_header));
-
-    uint8_t colors[5][4] = {
-        {255, 255, 255, 0},  // Белый
-        {0, 255, 0, 0},      // Зеленый
-        {128, 0, 128, 0},    // Фиолетовый
-        {255, 255, 0, 0},    // Желтый
-        {0, 0, 0, 0}         // Черный
-    };
-
-    for (int i = 0; i < 5; ++i) {
-        output_file.put(colors[i][2]);  // B
-        output_file.put(colors[i][1]);  // G
-        output_file.put(colors[i][0]);  // R
-        output_file.put(colors[i][3]);  // A
+    /* BMP хранит строки снизу вверх */
+    for (int y = 0; y < height; ++y) {
+        const void *row = matrix.GetRow(y);
+        switch (matrix.GetCellWidth()) {
+            case CellWidth::k16:
+                ClampRowToPalette(static_cast<const uint16_t *>(row), indices,
+                                  width);
+                break;
+            case CellWidth::k32:
+                ClampRowToPalette(static_cast<const uint32_t *>(row), indices,
+                                  width);
+                break;
+            case CellWidth::k64:
+                ClampRowToPalette(static_cast<const uint64_t *>(row), indices,
+                                  width);
+                break;
+        }
+        uint8_t *out =
+            pixels + static_cast<size_t>(height - 1 - y) * row_size;
+        PackNibbles(indices, out, width);
+        // Дополнение до кратного 4 для размера строки
+        for (int p = (width + 1) / 2; p < row_size; ++p) {
+            out[p] = 0;
+        }
     }
 
-    // Дополнение оставшихся цветов черным
-    for (int i = 5; i < 16; ++i) {
-        output_file.put(0);  // Черный
-        output_file.put(0);
-        output_file.put(0);
-        output_file.put(0);
+    delete[] indices;
+}
+
+bool WriteBMPImage(const char *filename, int width, int height,
+                   const uint8_t *pixels) {
+    std::ofstream output_file;
+    if (!OpenBMP(filename, width, height, output_file)) {
+        return false;
     }
+    output_file.write(reinterpret_cast<const char *>(pixels),
+                      static_cast<size_t>(BMPRowSize(width)) * height);
+    output_file.close();
+    return static_cast<bool>(output_file);
+}
+
+bool WriteBMP(const char *filename, const DynamicMatrix &matrix) {
+    int width = matrix.GetWidth();
+    int height = matrix.GetHeight();
+    uint8_t *pixels =
+        new uint8_t[static_cast<size_t>(BMPRowSize(width)) * height];
+
+    EncodeBMPImage(matrix, pixels);
+    bool written = WriteBMPImage(filename, width, height, pixels);
+    delete[] pixels;
+    return written;
+}
+
+/* Разреженная сетка пишется полосами по одной строке плиток: целиком
+   изображение может не поместиться в память */
+bool WriteBMP(const char *filename, const TiledMatrix &matrix) {
+    const int tile_size = TiledMatrix::kTileSize;
+    int width = matrix.GetWidth();
+    int height = matrix.GetHeight();
+    int min_x = matrix.GetMinX();
+    int min_y = matrix.GetMinY();
+    int max_x = min_x + width - 1;
+    int max_y = min_y + height - 1;
+    int row_size = BMPRowSize(width);
 
-    for (int y = height - 1; y >= 0; --y) {
-        for (int x = 0; x < width; x += 2) {
-            uint8_t pixel1 = matrix.Get(x + min_x, y + min_y);
-            uint8_t pixel2 =
-                (x + 1 < width) ? matrix.Get(x + 1 + min_x, y + min_y) : 0;
+    std::ofstream output_file;
+    if (!OpenBMP(filename, width, height, output_file)) {
+        return false;
+    }
 
-            pixel1 = (pixel1 > 3) ? 4 : pixel1;  // Ограничение
-            pixel2 = (pixel2 > 3) ? 4 : pixel2;
+    int first_tile_x = min_x >> TiledMatrix::kTileShift;
+    int tile_columns = (max_x >> TiledMatrix::kTileShift) - first_tile_x + 1;
+    const uint64_t **band = new const uint64_t *[tile_columns];
+    uint8_t *indices = new uint8_t[width];
+    uint8_t *band_pixels = new uint8_t[static_cast<size_t>(row_size) *
+                                       tile_size]();
 
-            uint8_t byte = (pixel1 << 4) | (pixel2 & 0xF);
-            output_file.put(byte);
+    /* BMP хранит строки снизу вверх */
+    for (int tile_y = max_y >> TiledMatrix::kTileShift;
+         tile_y >= (min_y >> TiledMatrix::kTileShift); --tile_y) {
+        for (int t = 0; t < tile_columns; ++t) {
+            band[t] = matrix.GetTileCells(first_tile_x + t, tile_y);
         }
+        int top = tile_y * tile_size;
+        int from_y = top + tile_size - 1 < max_y ? top + tile_size - 1
+                                                 : max_y;
+        int to_y = top > min_y ? top : min_y;
 
-        // Дополнение до кратного 4 для размера строки
-        for (int p = 0; p < row_size - (width + 1) / 2; ++p) {
-            output_file.put(0);
+        uint8_t *out = band_pixels;
+        for (int y = from_y; y >= to_y; --y) {
+            int local_y = y - top;
+            for (int x = min_x; x <= max_x;) {
+                int t = (x >> TiledMatrix::kTileShift) - first_tile_x;
+                int local_x = x & (tile_size - 1);
+                int count = tile_size - local_x;
+                if (x + count - 1 > max_x) {
+                    count = max_x - x + 1;
+                }
+                if (band[t] == nullptr) {
+                    std::memset(indices + (x - min_x), 0, count);
+                } else {
+                    ClampRowToPalette(band[t] + local_y * tile_size + local_x,
+                                      indices + (x - min_x), count);
+                }
+                x += count;
+            }
+            PackNibbles(indices, out, width);
+            out += row_size;
         }
+        output_file.write(reinterpret_cast<const char *>(band_pixels),
+                          out - band_pixels);
     }
 
+    delete[] band;
+    delete[] indices;
+    delete[] band_pixels;
     output_file.close();
-    std::cout << "BMP successfully written: " << filename << std::endl;
+    return static_cast<bool>(output_file);
 }
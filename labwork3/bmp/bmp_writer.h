@@ -2,6 +2,7 @@
 #define BMP_WRITER_H
 
 #include "../matrix/matrix.h"
+#include "../matrix/tiled_matrix.h"
 
 #pragma pack(push, 1)
 
@@ -31,7 +32,19 @@ struct BMP_info_header {
 
 #pragma pack(pop)
 
-// Функция для записи BMP-файла на основе матрицы
-void WriteBMP(const char *filename, const DynamicMatrix &matrix);
+// Размер строки пикселей в байтах (4 бита на пиксель, кратно 4)
+int BMPRowSize(int width);
+
+// Кодирование всей сетки в пиксели BMP: строки снизу вверх, с дополнением.
+// Буфер должен вмещать BMPRowSize(width) * height байт
+void EncodeBMPImage(const DynamicMatrix &matrix, uint8_t *pixels);
+
+// Запись готовых пикселей: заголовки и данные двумя вызовами write
+bool WriteBMPImage(const char *filename, int width, int height,
+                   const uint8_t *pixels);
+
+// Функция для записи BMP-файла на основе матрицы; false, если не вышло
+bool WriteBMP(const char *filename, const DynamicMatrix &matrix);
+bool WriteBMP(const char *filename, const TiledMatrix &matrix);
 
 #endif  // BMP_WRITER_H
@@ -0,0 +1,170 @@
+#include "../checkpoint/checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const char kCheckpointMagic[4] = {'S', 'P', 'C', 'K'};
+const uint32_t kCheckpointVersion = 1;
+
+/* Наибольшее значение клетки заданной ширины: по нему Reset выберет
+   ту же ширину, что была при сохранении */
+uint64_t CheckpointMaxValue(uint8_t cell_width) {
+    switch (cell_width) {
+        case 2:
+            return UINT16_MAX;
+        case 4:
+            return UINT32_MAX;
+        default:
+            return UINT64_MAX;
+    }
+}
+
+/* Запись имени файла в каталог тоже надо сбросить на диск, иначе после
+   сбоя питания rename может не сохраниться */
+bool SyncDirectory(const char *filename) {
+    const char *slash = std::strrchr(filename, '/');
+    std::string directory =
+        slash == nullptr ? "."
+        : slash == filename ? "/"
+                            : std::string(filename, slash - filename);
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+}
+
+}  // namespace
+
+bool WriteCheckpoint(const char *filename, const DynamicMatrix &matrix,
+                     uint32_t iteration) {
+    Checkpoint_header header;
+    std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+    header.version = kCheckpointVersion;
+    header.iteration = iteration;
+    header.min_x = matrix.GetMinX();
+    header.min_y = matrix.GetMinY();
+    header.width = matrix.GetWidth();
+    header.height = matrix.GetHeight();
+    header.cell_width = static_cast<uint8_t>(matrix.GetCellWidth());
+    std::memset(header.reserved, 0, sizeof(header.reserved));
+    size_t row_bytes = static_cast<size_t>(header.width) * header.cell_width;
+    header.data_size = row_bytes * header.height;
+    size_t file_size = sizeof(header) + header.data_size;
+
+    char temp_filename[512];
+    std::snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", filename);
+    int fd = open(temp_filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Checkpoint could not be opened" << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        std::cerr << "Checkpoint could not be resized" << std::endl;
+        close(fd);
+        return false;
+    }
+    void *mapped =
+        mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Checkpoint could not be mapped" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    /* Строки окна лежат в буфере с шагом stride: копируем их подряд */
+    uint8_t *out = static_cast<uint8_t *>(mapped);
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (int row = 0; row < header.height; ++row) {
+        std::memcpy(out, matrix.GetRow(row), row_bytes);
+        out += row_bytes;
+    }
+
+    /* Новая точка должна целиком оказаться на диске до того, как заменит
+       старую: иначе после сбоя питания останется пустой или рваный файл */
+    bool synced = msync(mapped, file_size, MS_SYNC) == 0;
+    munmap(mapped, file_size);
+    synced = fsync(fd) == 0 && synced;
+    close(fd);
+    if (!synced) {
+        std::cerr << "Checkpoint could not be synced" << std::endl;
+        std::remove(temp_filename);
+        return false;
+    }
+
+    if (std::rename(temp_filename, filename) != 0) {
+        std::cerr << "Checkpoint could not be renamed" << std::endl;
+        return false;
+    }
+    if (!SyncDirectory(filename)) {
+        std::cerr << "Checkpoint directory could not be synced" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReadCheckpoint(const char *filename, DynamicMatrix &matrix,
+                    uint32_t &iteration) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Checkpoint could not be opened" << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Checkpoint_header)) {
+        std::cerr << "Checkpoint is too small" << std::endl;
+        close(fd);
+        return false;
+    }
+    size_t file_size = static_cast<size_t>(st.st_size);
+    void *mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Checkpoint could not be mapped" << std::endl;
+        return false;
+    }
+
+    const uint8_t *data = static_cast<const uint8_t *>(mapped);
+    Checkpoint_header header;
+    std::memcpy(&header, data, sizeof(header));
+    bool valid_width = header.cell_width == 2 || header.cell_width == 4 ||
+                       header.cell_width == 8;
+    size_t row_bytes =
+        valid_width && header.width > 0
+            ? static_cast<size_t>(header.width) * header.cell_width
+            : 0;
+    if (std::memcmp(header.magic, kCheckpointMagic,
+                    sizeof(kCheckpointMagic)) != 0 ||
+        header.version != kCheckpointVersion || row_bytes == 0 ||
+        header.height <= 0 || header.data_size != row_bytes * header.height ||
+        sizeof(header) + header.data_size > file_size) {
+        std::cerr << "Invalid checkpoint format" << std::endl;
+        munmap(mapped, file_size);
+        return false;
+    }
+
+    matrix.Reset(header.min_x, header.min_y, header.min_x + header.width - 1,
+                 header.min_y + header.height - 1,
+                 CheckpointMaxValue(header.cell_width));
+    const uint8_t *in = data + sizeof(header);
+    for (int row = 0; row < header.height; ++row) {
+        std::memcpy(matrix.GetRow(row), in, row_bytes);
+        in += row_bytes;
+    }
+    iteration = header.iteration;
+    munmap(mapped, file_size);
+    return true;
+}
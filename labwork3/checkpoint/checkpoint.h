@@ -0,0 +1,38 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+
+#include "../matrix/matrix.h"
+
+#pragma pack(push, 1)
+
+/* Заголовок контрольной точки. За ним идут height строк по width клеток
+   шириной cell_width байт, без запаса и нулевой рамки */
+struct Checkpoint_header {
+    char magic[4];        // "SPCK"
+    uint32_t version;     // версия формата
+    uint32_t iteration;   // с какой итерации продолжать
+    int32_t min_x;        // координаты левого верхнего угла
+    int32_t min_y;
+    int32_t width;        // ширина сетки
+    int32_t height;       // высота сетки
+    uint8_t cell_width;   // байт на клетку (2, 4 или 8)
+    uint8_t reserved[3];
+    uint64_t data_size;   // байт клеток после заголовка
+};
+
+#pragma pack(pop)
+
+/* Сохранение точного состояния сетки, в отличие от BMP, где количество
+   песчинок обрезается до цвета. Файл пишется через mmap во временный
+   файл и переименовывается, поэтому прежняя точка не портится, если
+   процесс упадёт во время записи */
+bool WriteCheckpoint(const char *filename, const DynamicMatrix &matrix,
+                     uint32_t iteration);
+
+/* Восстановление сетки и номера итерации, с которой продолжать */
+bool ReadCheckpoint(const char *filename, DynamicMatrix &matrix,
+                    uint32_t &iteration);
+
+#endif  // CHECKPOINT_H
@@ -0,0 +1,44 @@
+/*
+Извлечение кадров из контейнера в обычные BMP-файлы.
+
+    ./extract_frames <контейнер> [директория]
+*/
+
+#include <cstdio>
+#include <iostream>
+
+#include "../bmp/bmp_writer.h"
+#include "../frames/frame_container.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: extract_frames <container> [output directory]"
+                  << std::endl;
+        return 1;
+    }
+    const char *directory = argc > 2 ? argv[2] : ".";
+
+    FrameReader reader;
+    if (!reader.Open(argv[1])) {
+        return 1;
+    }
+
+    Frame_header header;
+    const uint8_t *pixels;
+    uint32_t extracted = 0;
+    while (reader.Next(header, pixels)) {
+        char bmp_filename[512];
+        snprintf(bmp_filename, sizeof(bmp_filename),
+                 "%s/BMP_pictures_iteration_%u.bmp", directory,
+                 header.iteration);
+        if (!WriteBMPImage(bmp_filename, header.width, header.height,
+                           pixels)) {
+            return 1;
+        }
+        ++extracted;
+    }
+
+    std::cout << "Extracted " << extracted << " of "
+              << reader.GetFrameCount() << " frames" << std::endl;
+    return extracted == reader.GetFrameCount() ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+#include "../frames/frame_container.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "../bmp/bmp_writer.h"
+
+namespace {
+
+const char kFrameMagic[4] = {'S', 'P', 'F', 'C'};
+const uint32_t kFrameVersion = 1;
+const size_t kInitialContainerSize = 1 << 20;
+
+}  // namespace
+
+//==============Запись контейнера==============
+
+FrameContainer::FrameContainer()
+    : fd(-1),
+      data(nullptr),
+      capacity(0),
+      data_end(0),
+      frame_count(0),
+      last_frame(),
+      previous(nullptr),
+      current(nullptr),
+      pixels_capacity(0) {}
+
+FrameContainer::~FrameContainer() {
+    Close();
+    delete[] previous;
+    delete[] current;
+}
+
+bool FrameContainer::Open(const char *filename) {
+    fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Container could not be opened" << std::endl;
+        return false;
+    }
+    data_end = sizeof(Frame_file_header);
+    frame_count = 0;
+    return Map(kInitialContainerSize);
+}
+
+/* Увеличение файла и повторное отображение, запас растёт вдвое */
+bool FrameContainer::Map(size_t new_capacity) {
+    if (data != nullptr) {
+        munmap(data, capacity);
+        data = nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(new_capacity)) != 0) {
+        std::cerr << "Container could not be resized" << std::endl;
+        return false;
+    }
+    void *mapped = mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Container could not be mapped" << std::endl;
+        return false;
+    }
+    data = static_cast<uint8_t *>(mapped);
+    capacity = new_capacity;
+    return true;
+}
+
+bool FrameContainer::Reserve(size_t bytes) {
+    if (data_end + bytes <= capacity) {
+        return true;
+    }
+    size_t new_capacity = capacity;
+    while (data_end + bytes > new_capacity) {
+        new_capacity *= 2;
+    }
+    return Map(new_capacity);
+}
+
+bool FrameContainer::Append(uint32_t iteration, const DynamicMatrix &matrix) {
+    if (data == nullptr) {
+        return false;
+    }
+
+    Frame_header header;
+    header.iteration = iteration;
+    header.width = matrix.GetWidth();
+    header.height = matrix.GetHeight();
+    header.min_x = matrix.GetMinX();
+    header.min_y = matrix.GetMinY();
+    header.row_size = BMPRowSize(header.width);
+
+    size_t image_size = static_cast<size_t>(header.row_size) * header.height;
+    if (image_size > pixels_capacity) {
+        delete[] previous;
+        delete[] current;
+        previous = new uint8_t[image_size];
+        current = new uint8_t[image_size];
+        pixels_capacity = image_size;
+    }
+    /* Буферы перевыделяются только при росте сетки, а тогда кадр будет
+       ключевым и прежние пиксели не нужны */
+    EncodeBMPImage(matrix, current);
+
+    /* Ключевой кадр, если это первый кадр или сетка изменила размер */
+    header.keyframe = frame_count == 0 || last_frame.width != header.width ||
+                      last_frame.height != header.height ||
+                      last_frame.min_x != header.min_x ||
+                      last_frame.min_y != header.min_y;
+
+    size_t record_size = sizeof(uint32_t) + header.row_size;
+    if (!Reserve(sizeof(Frame_header) + record_size * header.height)) {
+        return false;
+    }
+
+    uint8_t *out = data + data_end + sizeof(Frame_header);
+    uint32_t changed = 0;
+    for (int32_t row = 0; row < header.height; ++row) {
+        const uint8_t *pixels =
+            current + static_cast<size_t>(row) * header.row_size;
+        if (!header.keyframe &&
+            std::memcmp(pixels,
+                        previous + static_cast<size_t>(row) * header.row_size,
+                        header.row_size) == 0) {
+            continue;
+        }
+        uint32_t index = static_cast<uint32_t>(row);
+        std::memcpy(out, &index, sizeof(index));
+        std::memcpy(out + sizeof(index), pixels, header.row_size);
+        out += record_size;
+        ++changed;
+    }
+    header.changed_rows = changed;
+    std::memcpy(data + data_end, &header, sizeof(header));
+    data_end += sizeof(Frame_header) + record_size * changed;
+    ++frame_count;
+
+    last_frame = header;
+    uint8_t *tmp = previous;
+    previous = current;
+    current = tmp;
+    return true;
+}
+
+void FrameContainer::Close() {
+    if (fd < 0) {
+        return;
+    }
+    if (data != nullptr) {
+        Frame_file_header file_header;
+        std::memcpy(file_header.magic, kFrameMagic, sizeof(kFrameMagic));
+        file_header.version = kFrameVersion;
+        file_header.frame_count = frame_count;
+        file_header.reserved = 0;
+        file_header.data_end = data_end;
+        std::memcpy(data, &file_header, sizeof(file_header));
+        munmap(data, capacity);
+        data = nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(data_end)) != 0) {
+        std::cerr << "Container could not be truncated" << std::endl;
+    }
+    close(fd);
+    fd = -1;
+}
+
+//==============Чтение контейнера==============
+
+FrameReader::FrameReader()
+    : fd(-1),
+      data(nullptr),
+      mapped_size(0),
+      size(0),
+      position(0),
+      frame_count(0),
+      frames_read(0),
+      pixels(nullptr),
+      pixels_capacity(0) {}
+
+FrameReader::~FrameReader() {
+    if (data != nullptr) {
+        munmap(const_cast<uint8_t *>(data), mapped_size);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    delete[] pixels;
+}
+
+bool FrameReader::Open(const char *filename) {
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Container could not be opened" << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Frame_file_header)) {
+        std::cerr << "Container is too small" << std::endl;
+        return false;
+    }
+    mapped_size = static_cast<size_t>(st.st_size);
+    void *mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Container could not be mapped" << std::endl;
+        return false;
+    }
+    data = static_cast<const uint8_t *>(mapped);
+
+    Frame_file_header file_header;
+    std::memcpy(&file_header, data, sizeof(file_header));
+    if (std::memcmp(file_header.magic, kFrameMagic, sizeof(kFrameMagic)) != 0 ||
+        file_header.version != kFrameVersion ||
+        file_header.data_end > mapped_size) {
+        std::cerr << "Invalid container format" << std::endl;
+        return false;
+    }
+    size = file_header.data_end;
+    frame_count = file_header.frame_count;
+    position = sizeof(Frame_file_header);
+    return true;
+}
+
+uint32_t FrameReader::GetFrameCount() const { return frame_count; }
+
+bool FrameReader::Next(Frame_header &header, const uint8_t *&frame_pixels) {
+    if (frames_read >= frame_count ||
+        position + sizeof(Frame_header) > size) {
+        return false;
+    }
+    std::memcpy(&header, data + position, sizeof(header));
+    position += sizeof(Frame_header);
+
+    size_t image_size = static_cast<size_t>(header.row_size) * header.height;
+    if (image_size > pixels_capacity) {
+        delete[] pixels;
+        pixels = new uint8_t[image_size]();
+        pixels_capacity = image_size;
+    }
+
+    size_t record_size = sizeof(uint32_t) + header.row_size;
+    if (position + record_size * header.changed_rows > size) {
+        std::cerr << "Truncated frame" << std::endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < header.changed_rows; ++i) {
+        uint32_t row;
+        std::memcpy(&row, data + position, sizeof(row));
+        if (row >= static_cast<uint32_t>(header.height)) {
+            std::cerr << "Invalid row in frame" << std::endl;
+            return false;
+        }
+        std::memcpy(pixels + static_cast<size_t>(row) * header.row_size,
+                    data + position + sizeof(row), header.row_size);
+        position += record_size;
+    }
+
+    ++frames_read;
+    frame_pixels = pixels;
+    return true;
+}
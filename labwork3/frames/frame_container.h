@@ -0,0 +1,90 @@
+#ifndef FRAME_CONTAINER_H
+#define FRAME_CONTAINER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../matrix/matrix.h"
+
+#pragma pack(push, 1)
+
+/* Заголовок файла-контейнера кадров */
+struct Frame_file_header {
+    char magic[4];         // "SPFC"
+    uint32_t version;      // версия формата
+    uint32_t frame_count;  // количество кадров
+    uint32_t reserved;
+    uint64_t data_end;  // конец последнего кадра, дальше - запас
+};
+
+/* Заголовок кадра. За ним идут changed_rows записей:
+   uint32_t номер строки BMP (снизу вверх) + row_size байт пикселей */
+struct Frame_header {
+    uint32_t iteration;     // номер итерации
+    int32_t width;          // ширина сетки
+    int32_t height;         // высота сетки
+    int32_t min_x;          // координаты левого верхнего угла
+    int32_t min_y;
+    uint32_t row_size;      // байт в строке пикселей (как в BMP)
+    uint32_t changed_rows;  // сколько строк записано в кадре
+    uint32_t keyframe;      // 1 - записаны все строки
+};
+
+#pragma pack(pop)
+
+/* Один файл на все снимки: файл заранее увеличивается и отображается
+   в память, каждый кадр хранит только строки, изменившиеся с прошлого
+   кадра. Если размер сетки поменялся, кадр записывается целиком */
+class FrameContainer {
+   public:
+    FrameContainer();
+    ~FrameContainer();
+    FrameContainer(const FrameContainer &) = delete;
+    FrameContainer &operator=(const FrameContainer &) = delete;
+
+    bool Open(const char *filename);
+    bool Append(uint32_t iteration, const DynamicMatrix &matrix);
+    void Close();  // Обрезает файл до данных и записывает заголовок
+
+   private:
+    int fd;
+    uint8_t *data;
+    size_t capacity;
+    size_t data_end;
+    uint32_t frame_count;
+
+    Frame_header last_frame;  // Геометрия предыдущего кадра
+    uint8_t *previous;        // Пиксели предыдущего кадра
+    uint8_t *current;         // Пиксели текущего кадра
+    size_t pixels_capacity;
+
+    bool Reserve(size_t bytes);
+    bool Map(size_t new_capacity);
+};
+
+/* Чтение контейнера: восстанавливает кадры по порядку */
+class FrameReader {
+   public:
+    FrameReader();
+    ~FrameReader();
+    FrameReader(const FrameReader &) = delete;
+    FrameReader &operator=(const FrameReader &) = delete;
+
+    bool Open(const char *filename);
+    uint32_t GetFrameCount() const;
+    /* Следующий кадр; пиксели в формате BMP (строки снизу вверх) */
+    bool Next(Frame_header &header, const uint8_t *&pixels);
+
+   private:
+    int fd;
+    const uint8_t *data;
+    size_t mapped_size;
+    size_t size;  // Конец данных кадров
+    size_t position;
+    uint32_t frame_count;
+    uint32_t frames_read;
+    uint8_t *pixels;
+    size_t pixels_capacity;
+};
+
+#endif  // FRAME_CONTAINER_H
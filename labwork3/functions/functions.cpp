@@ -1,9 +1,13 @@
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 
 /*Перевод из строки в int*/
 int StrToInt(const char *str) {
     int result = 0;
+    if (str[0] == '-') {  // Отрицательные координаты
+        return -StrToInt(str + 1);
+    }
     for (int i = 0; str[i] != '\0'; i++) {
         if ((str[i] >= '0') && (str[i] <= '9')) {
             result = result * 10 + (str[i] - '0');
@@ -2,79 +2,84 @@
 Struct of this Sandpile project:
 
     /bmp
+        - async_writer.cpp (фоновая запись)
         - bmp_writer.cpp - - - - - - - - -|
         - bmp_writer.h   <- - - - |       |
                                   |       |
     /matrix                       |       |
         - matrix.cpp              |       |
         - matrix.h       - - - - -| - - ->|
+        - tiled_matrix.cpp (разреженная сетка, --sparse)
                                           |
     /pars-args                            |
         - pars-args.cpp  - - - - - - - - >|
                                           |
     /parser-tsv                           |
-        - read-tsv.cpp  - - - - - - - - ->|
+        - tsv_loader.cpp - - - - - - - - >|
+                                          |
+    /sandpile                             |
+        - sandpile.cpp  - - - - - - - - ->|
+        - sandpile.h                      |
                                           |
     Root:                                 |
         main.cpp  <- - - - - - - - - - - -|
 
 
     Instruments:
+    /frames
+        - frame_container.cpp - кадры в одном файле (--container)
+        - extract_frames.cpp - извлечение кадров в BMP
     /functions
         - functions.cpp
         - functions.h
+    /stencil
+        - stencil.cpp - шаг осыпания (AVX2 / скалярный)
+        - stencil.h
+    /checkpoint
+        - checkpoint.cpp - точное состояние сетки (--checkpoint, --resume)
+    /bench
+        - stencil_bench.cpp - замер скорости шага
+        - bmp_bench.cpp - замер кодирования BMP
+        - tsv_bench.cpp - замер загрузки начального состояния
+        - pipeline_bench.cpp - замер всего конвейера по фазам (ctest)
 
 P.S special for Fedor Konstantinevich <3
 */
 
+#include "../bmp/async_writer.cpp"
 #include "../bmp/bmp_writer.cpp"
+#include "../checkpoint/checkpoint.cpp"
+#include "../frames/frame_container.cpp"
 #include "../matrix/matrix.cpp"
+#include "../matrix/tiled_matrix.cpp"
 #include "../pars-args/pars-args.cpp"
-#include "../parser-tsv/read-tsv.cpp"
+#include "../functions/functions.cpp"
+#include "../parser-tsv/tsv_loader.cpp"
 #include "../sandpile/sandpile.cpp"
+#include "../stencil/stencil.cpp"
 #include <iostream>
-#include <fstream>
+#include <type_traits>
 
-int main(int argc, char **argv) {
-    /* Место под переменные */
-    const char *filename = nullptr;
-    const char *output_file = nullptr;
-    int max_iter = 0;
-    int freq = 1;  // Значение по умолчанию для частоты
-    int size_of_buffer = 512;
-    char buffer[size_of_buffer];
-    log_s logs;
-    bool flag_for_topple;
-    /* Конец переменных */
-
-    /* Парсинг аргументов командной строки */
-    ParsArgs(argc, argv, filename, output_file, max_iter, freq);
-
-    /* Открытие файла */
-    std::ifstream input_file(filename);
-
-    /* Проверяем на открытие */
-    if (!input_file.is_open()) {
-        std::cerr << "File could not be opened" << '\n';
-        return 1;
-    }
+/* Параметры цикла симуляции */
+struct Simulation_options {
+    int first_iter;               // С какой итерации начинать
+    int max_iter;
+    int freq;
+    const char *checkpoint_file;  // nullptr - без контрольных точек
+    int checkpoint_freq;
+};
 
-    /* Инициализация матрицы песчаной кучи */
-    DynamicMatrix sandpile_matrix; 
-    Sandpile sandpile(sandpile_matrix); 
-
-    while (input_file.getline(buffer, size_of_buffer)) {
-        ParsTSVFile(buffer, logs); 
-        sandpile_matrix.AddGrains(logs.width, logs.height,
-                                  logs.count); 
-    }
-
-    /* Закрываем файл */
-    input_file.close();
+/* Итеративная симуляция песчаной кучи; одна и та же для плотной
+   и разреженной сетки. Контрольные точки есть только у плотной */
+template <typename Matrix>
+void Simulate(Matrix &sandpile_matrix, AsyncBMPWriter &bmp_writer,
+              const Simulation_options &options) {
+    Sandpile sandpile(sandpile_matrix);
+    bool flag_for_topple;
+    int current_iter = options.first_iter;
 
-    /* Итеративная симуляция песчаной кучи */
-    for (int current_iter = 0; current_iter < max_iter; ++current_iter) {
-        if (current_iter % freq == 0) {
+    for (; current_iter < options.max_iter; ++current_iter) {
+        if (current_iter % options.freq == 0) {
             flag_for_topple = true;
         } else {
             flag_for_topple = false;
@@ -86,17 +91,110 @@ int main(int argc, char **argv) {
             char bmp_filename[256];
             snprintf(bmp_filename, sizeof(bmp_filename),
                      "BMP_pictures_iteration_%d.bmp", current_iter);
-            WriteBMP(bmp_filename, sandpile_matrix);
-            std::cout << "BMP successfully written: " << bmp_filename
-                      << std::endl;
+            bmp_writer.Submit(bmp_filename, sandpile_matrix, current_iter);
         }
         /* Проверка на стабильность */
         if (sandpile.IsStable()) {
+            bmp_writer.Flush();
             std::cout << "Sandpile stabilized at iteration " << current_iter
                       << std::endl;
             sandpile_matrix.PrintMatrix();  // Печать стабильной матрицы
+            ++current_iter;
             break;
         }
+        if constexpr (std::is_same<Matrix, DynamicMatrix>::value) {
+            if (options.checkpoint_file != nullptr &&
+                (current_iter + 1) % options.checkpoint_freq == 0) {
+                WriteCheckpoint(options.checkpoint_file, sandpile_matrix,
+                                static_cast<uint32_t>(current_iter + 1));
+            }
+        }
+    }
+
+    bmp_writer.Flush();
+
+    /* Последняя точка позволяет продолжить с большим --max-iter */
+    if constexpr (std::is_same<Matrix, DynamicMatrix>::value) {
+        if (options.checkpoint_file != nullptr) {
+            WriteCheckpoint(options.checkpoint_file, sandpile_matrix,
+                            static_cast<uint32_t>(current_iter));
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    /* Место под переменные */
+    const char *filename = nullptr;
+    const char *output_file = nullptr;
+    const char *container_file = nullptr;
+    int max_iter = 0;
+    int freq = 1;  // Значение по умолчанию для частоты
+    bool sparse = false;
+    const char *checkpoint_file = nullptr;
+    const char *resume_file = nullptr;
+    int checkpoint_freq = 1000;  // Итераций между контрольными точками
+    uint32_t resume_iter = 0;
+    TSVLoader loader;
+    /* Конец переменных */
+
+    /* Парсинг аргументов командной строки */
+    ParsArgs(argc, argv, filename, output_file, max_iter, freq,
+             container_file, sparse, checkpoint_file, checkpoint_freq,
+             resume_file);
+
+    if (sparse && container_file != nullptr) {
+        std::cerr << "--container is not supported with --sparse" << '\n';
+        return 1;
+    }
+    if (sparse && (checkpoint_file != nullptr || resume_file != nullptr)) {
+        std::cerr << "Checkpoints are not supported with --sparse" << '\n';
+        return 1;
+    }
+    if (checkpoint_freq <= 0) {
+        checkpoint_freq = 1;
+    }
+
+    /* Загрузка начального состояния целиком, если не продолжаем
+       с контрольной точки */
+    if (resume_file == nullptr) {
+        if (filename == nullptr) {
+            std::cerr << "Input file is not specified" << '\n';
+            return 1;
+        }
+        if (!loader.Load(filename)) {
+            return 1;
+        }
+    }
+
+    /* Инициализация матрицы песчаной кучи */
+    DynamicMatrix sandpile_matrix; 
+    TiledMatrix sparse_matrix;
+    FrameContainer frame_container;
+    AsyncBMPWriter bmp_writer;  // Картинки пишутся в фоновом потоке
+    if (container_file != nullptr) {
+        if (!frame_container.Open(container_file)) {
+            return 1;
+        }
+        bmp_writer.SetContainer(&frame_container);
+    }
+
+    if (resume_file != nullptr) {
+        if (!ReadCheckpoint(resume_file, sandpile_matrix, resume_iter)) {
+            return 1;
+        }
+        std::cout << "Resuming from iteration " << resume_iter << std::endl;
+    } else if (sparse) {
+        loader.Fill(sparse_matrix);
+    } else {
+        loader.Fill(sandpile_matrix);
+    }
+
+    Simulation_options options = {static_cast<int>(resume_iter), max_iter,
+                                  freq, checkpoint_file, checkpoint_freq};
+    if (sparse) {
+        Simulate(sparse_matrix, bmp_writer, options);
+    } else {
+        Simulate(sandpile_matrix, bmp_writer, options);
     }
     return 0;
 }
\ No newline at end of file
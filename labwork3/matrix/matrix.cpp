@@ -1,7 +1,70 @@
 #include "../matrix/matrix.h"
 
+#include <cstring>
 #include <iostream>
 
+namespace {
+
+/* Типизированный доступ к клетке плоского буфера */
+template <typename T>
+T *CellPtr(uint8_t *base, int stride, int row, int col) {
+    return reinterpret_cast<T *>(base) + static_cast<int64_t>(row) * stride +
+           col;
+}
+
+template <typename T>
+const T *CellPtr(const uint8_t *base, int stride, int row, int col) {
+    return reinterpret_cast<const T *>(base) +
+           static_cast<int64_t>(row) * stride + col;
+}
+
+/* Максимальное значение, которое помещается в клетку данной ширины */
+uint64_t MaxCellValue(CellWidth width) {
+    switch (width) {
+        case CellWidth::k16:
+            return UINT16_MAX;
+        case CellWidth::k32:
+            return UINT32_MAX;
+        default:
+            return UINT64_MAX;
+    }
+}
+
+/* Копирование строки с возможным расширением типа */
+template <typename From, typename To>
+void CopyRow(const From *src, To *dst, int count) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = static_cast<To>(src[i]);
+    }
+}
+
+template <typename From>
+void CopyRowTo(const From *src, uint8_t *dst, CellWidth dst_width,
+               int count) {
+    switch (dst_width) {
+        case CellWidth::k16:
+            CopyRow(src, reinterpret_cast<uint16_t *>(dst), count);
+            break;
+        case CellWidth::k32:
+            CopyRow(src, reinterpret_cast<uint32_t *>(dst), count);
+            break;
+        case CellWidth::k64:
+            CopyRow(src, reinterpret_cast<uint64_t *>(dst), count);
+            break;
+    }
+}
+
+template <typename T>
+bool RowHasUnstable(const T *row, int count) {
+    T acc = 0;
+    for (int i = 0; i < count; ++i) {
+        acc |= row[i] >> 2;
+    }
+    return acc != 0;
+}
+
+}  // namespace
+
 DynamicMatrix::DynamicMatrix()
     : rows(1),
       cols(1),
@@ -9,9 +72,12 @@ DynamicMatrix::DynamicMatrix()
       max_x(0),
       min_y(0),
       max_y(0),
+      cell_width(CellWidth::k16),
+      cells(nullptr),
+      back_cells(nullptr),
+      growth_count(0),
       save_bmp_flag(false) {
-    matrix = new uint64_t*[rows];
-    matrix[0] = new uint64_t[cols]();
+    Allocate(rows, cols);
 }
 
 DynamicMatrix::DynamicMatrix(int initial_rows, int initial_cols)
@@ -21,11 +87,12 @@ DynamicMatrix::DynamicMatrix(int initial_rows, int initial_cols)
       max_x(initial_cols - 1),
       min_y(0),
       max_y(initial_rows - 1),
+      cell_width(CellWidth::k16),
+      cells(nullptr),
+      back_cells(nullptr),
+      growth_count(0),
       save_bmp_flag(false) {
-    matrix = new uint64_t*[rows];
-    for (int i = 0; i < rows; ++i) {
-        matrix[i] = new uint64_t[cols]();
-    }
+    Allocate(rows, cols);
 }
 
 DynamicMatrix::~DynamicMatrix() { ClearOldMatrix(); }
@@ -34,19 +101,22 @@ void DynamicMatrix::AddGrains(int x, int y, uint64_t grains) {
     Expand(x, y);
     int row = y - min_y;
     int col = x - min_x;
-    matrix[row][col] += grains;
+    uint64_t value = GetCell(row, col) + grains;
+    Widen(value);
+    SetCell(row, col, value);
 }
 
 uint64_t DynamicMatrix::Get(int x, int y) const {
     if (IsWithinBounds(x, y)) {
-        return matrix[y - min_y][x - min_x];
+        return GetCell(y - min_y, x - min_x);
     }
     return 0;
 }
 
 void DynamicMatrix::Set(int x, int y, uint64_t grains) {
     Expand(x, y);
-    matrix[y - min_y][x - min_x] = grains;
+    Widen(grains);
+    SetCell(y - min_y, x - min_x, grains);
 }
 
 int DynamicMatrix::GetWidth() const { return cols; }
@@ -60,96 +130,269 @@ int DynamicMatrix::GetMinY() const { return min_y; }
 void DynamicMatrix::PrintMatrix() const {
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
-            std::cout << matrix[i][j] << " ";
+            std::cout << GetCell(i, j) << " ";
         }
         std::cout << std::endl;
     }
 }
 
+/* Расширяем сетку, пока точка не окажется внутри */
 void DynamicMatrix::Expand(int x, int y) {
-    if (x < min_x) ExpandLeft();
-    if (x > max_x) ExpandRight();
-    if (y < min_y) ExpandUp();
-    if (y > max_y) ExpandDown();
+    while (x < min_x) ExpandLeft();
+    while (x > max_x) ExpandRight();
+    while (y < min_y) ExpandUp();
+    while (y > max_y) ExpandDown();
 }
 
+/* Расширение сдвигает окно в запас буфера; перевыделение происходит,
+   только когда запас кончился, и удваивает буфер по этой оси */
 void DynamicMatrix::ExpandLeft() {
+    if (off_col < 2) {
+        int new_cap = cap_cols * 2;
+        Reallocate(cap_rows, new_cap, off_row, off_col + (new_cap - cap_cols),
+                   cell_width);
+    }
     min_x -= 1;
-    int new_cols = cols + 1;
+    off_col -= 1;
+    cols += 1;
+}
 
-    uint64_t** new_matrix = new uint64_t*[rows];
-    for (int i = 0; i < rows; ++i) {
-        new_matrix[i] = new uint64_t[new_cols]();
-        for (int j = 0; j < cols; ++j) {
-            new_matrix[i][j + 1] = matrix[i][j];
-        }
+void DynamicMatrix::ExpandRight() {
+    if (off_col + cols + 2 > cap_cols) {
+        Reallocate(cap_rows, cap_cols * 2, off_row, off_col, cell_width);
     }
+    max_x += 1;
+    cols += 1;
+}
 
-    ClearOldMatrix();
-    matrix = new_matrix;
-    cols = new_cols;
+void DynamicMatrix::ExpandUp() {
+    if (off_row < 2) {
+        int new_cap = cap_rows * 2;
+        Reallocate(new_cap, cap_cols, off_row + (new_cap - cap_rows), off_col,
+                   cell_width);
+    }
+    min_y -= 1;
+    off_row -= 1;
+    rows += 1;
 }
 
-void DynamicMatrix::ExpandRight() {
-    max_x += 1;
-    int new_cols = cols + 1;
+void DynamicMatrix::ExpandDown() {
+    if (off_row + rows + 2 > cap_rows) {
+        Reallocate(cap_rows * 2, cap_cols, off_row, off_col, cell_width);
+    }
+    max_y += 1;
+    rows += 1;
+}
+
+CellWidth DynamicMatrix::GetCellWidth() const { return cell_width; }
 
-    uint64_t** new_matrix = new uint64_t*[rows];
+int DynamicMatrix::GetStride() const { return cap_cols; }
+
+const void *DynamicMatrix::GetRow(int row) const {
+    return cells + (static_cast<int64_t>(row + off_row) * cap_cols + off_col) *
+                       static_cast<int>(cell_width);
+}
+
+void *DynamicMatrix::GetRow(int row) {
+    return cells + (static_cast<int64_t>(row + off_row) * cap_cols + off_col) *
+                       static_cast<int>(cell_width);
+}
+
+void *DynamicMatrix::GetBackRow(int row) {
+    /* Второй буфер нужен только для шагов осыпания, у снимков его нет */
+    if (back_cells == nullptr) {
+        back_cells = new uint8_t[static_cast<size_t>(cap_rows) * cap_cols *
+                                 static_cast<int>(cell_width)]();
+    }
+    return back_cells +
+           (static_cast<int64_t>(row + off_row) * cap_cols + off_col) *
+               static_cast<int>(cell_width);
+}
+
+void DynamicMatrix::SwapBuffers() {
+    uint8_t *tmp = cells;
+    cells = back_cells;
+    back_cells = tmp;
+}
+
+bool DynamicMatrix::HasUnstableCells() const {
     for (int i = 0; i < rows; ++i) {
-        new_matrix[i] = new uint64_t[new_cols]();
-        for (int j = 0; j < cols; ++j) {
-            new_matrix[i][j] = matrix[i][j];
+        const void *row = GetRow(i);
+        bool unstable = false;
+        switch (cell_width) {
+            case CellWidth::k16:
+                unstable = RowHasUnstable(
+                    static_cast<const uint16_t *>(row), cols);
+                break;
+            case CellWidth::k32:
+                unstable = RowHasUnstable(
+                    static_cast<const uint32_t *>(row), cols);
+                break;
+            case CellWidth::k64:
+                unstable = RowHasUnstable(
+                    static_cast<const uint64_t *>(row), cols);
+                break;
+        }
+        if (unstable) {
+            return true;
         }
     }
-
-    ClearOldMatrix();
-    matrix = new_matrix;
-    cols = new_cols;
+    return false;
 }
 
-void DynamicMatrix::ExpandUp() {
-    min_y -= 1;
-    int new_rows = rows + 1;
+int DynamicMatrix::GetGrowthCount() const { return growth_count; }
 
-    uint64_t** new_matrix = new uint64_t*[new_rows];
-    for (int i = 0; i < new_rows; ++i) {
-        new_matrix[i] = new uint64_t[cols]();
+/* Снимок окна другой матрицы; буфер переиспользуется, если хватает места */
+void DynamicMatrix::CopyFrom(const DynamicMatrix &other) {
+    bool fits = cell_width == other.cell_width &&
+                cap_rows >= other.rows + 2 && cap_cols >= other.cols + 2;
+    if (fits) {
+        /* Окно прежнего снимка могло быть шире: обнуляем его, чтобы вне
+           нового окна остались нули */
+        for (int i = 0; i < rows; ++i) {
+            std::memset(GetRow(i), 0,
+                        static_cast<size_t>(cols) *
+                            static_cast<int>(cell_width));
+        }
+    } else {
+        ClearOldMatrix();
+        cell_width = other.cell_width;
+        Allocate(other.rows, other.cols);
     }
+
+    /* Второй буфер пересоздастся при следующем шаге уже под новое окно */
+    delete[] back_cells;
+    back_cells = nullptr;
+
+    rows = other.rows;
+    cols = other.cols;
+    min_x = other.min_x;
+    max_x = other.max_x;
+    min_y = other.min_y;
+    max_y = other.max_y;
+    off_row = 1;
+    off_col = 1;
+    size_t row_bytes =
+        static_cast<size_t>(cols) * static_cast<int>(cell_width);
     for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            new_matrix[i + 1][j] = matrix[i][j];
-        }
+        std::memcpy(GetRow(i), other.GetRow(i), row_bytes);
     }
+}
 
+void DynamicMatrix::Reset(int new_min_x, int new_min_y, int new_max_x,
+                          int new_max_y, uint64_t max_value) {
     ClearOldMatrix();
-    matrix = new_matrix;
-    rows = new_rows;
+    cell_width = max_value <= UINT16_MAX   ? CellWidth::k16
+                 : max_value <= UINT32_MAX ? CellWidth::k32
+                                           : CellWidth::k64;
+    min_x = new_min_x;
+    max_x = new_max_x;
+    min_y = new_min_y;
+    max_y = new_max_y;
+    rows = max_y - min_y + 1;
+    cols = max_x - min_x + 1;
+    Allocate(rows, cols);
 }
 
-void DynamicMatrix::ExpandDown() {
-    max_y += 1;
-    int new_rows = rows + 1;
+void DynamicMatrix::ClearOldMatrix() {
+    delete[] cells;
+    delete[] back_cells;
+    cells = nullptr;
+    back_cells = nullptr;
+}
+
+/* Первичное выделение: окно плюс нулевая рамка в одну клетку */
+void DynamicMatrix::Allocate(int new_rows, int new_cols) {
+    cap_rows = new_rows + 2;
+    cap_cols = new_cols + 2;
+    off_row = 1;
+    off_col = 1;
+    size_t bytes = static_cast<size_t>(cap_rows) * cap_cols *
+                   static_cast<int>(cell_width);
+    cells = new uint8_t[bytes]();
+}
+
+void DynamicMatrix::Reallocate(int new_cap_rows, int new_cap_cols,
+                               int new_off_row, int new_off_col,
+                               CellWidth new_width) {
+    size_t bytes = static_cast<size_t>(new_cap_rows) * new_cap_cols *
+                   static_cast<int>(new_width);
+    uint8_t *new_cells = new uint8_t[bytes]();
+    uint8_t *new_back_cells =
+        back_cells != nullptr ? new uint8_t[bytes]() : nullptr;
 
-    uint64_t** new_matrix = new uint64_t*[new_rows];
-    for (int i = 0; i < new_rows; ++i) {
-        new_matrix[i] = new uint64_t[cols]();
-    }
     for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            new_matrix[i][j] = matrix[i][j];
+        uint8_t *dst =
+            new_cells + (static_cast<int64_t>(i + new_off_row) * new_cap_cols +
+                         new_off_col) *
+                            static_cast<int>(new_width);
+        const void *src = GetRow(i);
+        switch (cell_width) {
+            case CellWidth::k16:
+                CopyRowTo(static_cast<const uint16_t *>(src), dst, new_width,
+                          cols);
+                break;
+            case CellWidth::k32:
+                CopyRowTo(static_cast<const uint32_t *>(src), dst, new_width,
+                          cols);
+                break;
+            case CellWidth::k64:
+                CopyRowTo(static_cast<const uint64_t *>(src), dst, new_width,
+                          cols);
+                break;
         }
     }
 
     ClearOldMatrix();
-    matrix = new_matrix;
-    rows = new_rows;
+    cells = new_cells;
+    back_cells = new_back_cells;
+    cap_rows = new_cap_rows;
+    cap_cols = new_cap_cols;
+    off_row = new_off_row;
+    off_col = new_off_col;
+    cell_width = new_width;
+    ++growth_count;
 }
 
-void DynamicMatrix::ClearOldMatrix() {
-    for (int i = 0; i < rows; ++i) {
-        delete[] matrix[i];
+/* Расширение типа клетки, если значение в текущий не помещается */
+void DynamicMatrix::Widen(uint64_t value) {
+    if (value <= MaxCellValue(cell_width)) {
+        return;
+    }
+    CellWidth new_width = value <= UINT32_MAX ? CellWidth::k32
+                                              : CellWidth::k64;
+    Reallocate(cap_rows, cap_cols, off_row, off_col, new_width);
+}
+
+uint64_t DynamicMatrix::GetCell(int row, int col) const {
+    int prow = row + off_row;
+    int pcol = col + off_col;
+    switch (cell_width) {
+        case CellWidth::k16:
+            return *CellPtr<uint16_t>(cells, cap_cols, prow, pcol);
+        case CellWidth::k32:
+            return *CellPtr<uint32_t>(cells, cap_cols, prow, pcol);
+        default:
+            return *CellPtr<uint64_t>(cells, cap_cols, prow, pcol);
+    }
+}
+
+void DynamicMatrix::SetCell(int row, int col, uint64_t value) {
+    int prow = row + off_row;
+    int pcol = col + off_col;
+    switch (cell_width) {
+        case CellWidth::k16:
+            *CellPtr<uint16_t>(cells, cap_cols, prow, pcol) =
+                static_cast<uint16_t>(value);
+            break;
+        case CellWidth::k32:
+            *CellPtr<uint32_t>(cells, cap_cols, prow, pcol) =
+                static_cast<uint32_t>(value);
+            break;
+        case CellWidth::k64:
+            *CellPtr<uint64_t>(cells, cap_cols, prow, pcol) = value;
+            break;
     }
-    delete[] matrix;
 }
 
 bool DynamicMatrix::IsWithinBounds(int x, int y) const {
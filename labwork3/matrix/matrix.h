@@ -3,12 +3,18 @@
 
 #include <cstdint>
 
+/* Ширина ячейки в байтах: сетка хранится в самом узком типе, в который
+   помещаются все значения, и расширяется при переполнении */
+enum class CellWidth : uint8_t { k16 = 2, k32 = 4, k64 = 8 };
+
 class DynamicMatrix {
    public:
     DynamicMatrix();  // Конструктор по умолчанию
     DynamicMatrix(int initial_rows,
                   int initial_cols);  // Конструктор с параметрами
     ~DynamicMatrix();
+    DynamicMatrix(const DynamicMatrix &) = delete;
+    DynamicMatrix &operator=(const DynamicMatrix &) = delete;
 
     void AddGrains(int x, int y, uint64_t grains);
     uint64_t Get(int x, int y) const;
@@ -24,14 +30,44 @@ class DynamicMatrix {
     void ExpandUp();
     void ExpandDown();
 
+    /* Доступ к плоскому буферу для вычислительных ядер.
+       Вокруг окна rows x cols всегда есть хотя бы одна нулевая клетка,
+       поэтому ядро может читать соседей крайних клеток без проверок */
+    CellWidth GetCellWidth() const;
+    int GetStride() const;  // Расстояние между строками в клетках
+    const void *GetRow(int row) const;
+    void *GetRow(int row);
+    void *GetBackRow(int row);  // Строка второго буфера (для записи шага)
+    void SwapBuffers();
+    bool HasUnstableCells() const;  // Есть ли клетки с 4+ песчинками
+    int GetGrowthCount() const;     // Сколько раз перевыделялся буфер
+    void CopyFrom(const DynamicMatrix &other);  // Дешёвый снимок состояния
+    /* Пустая сетка с окном [min_x, max_x] x [min_y, max_y], выделенная
+       за один раз под клетки не больше max_value */
+    void Reset(int new_min_x, int new_min_y, int new_max_x, int new_max_y,
+               uint64_t max_value);
+
    private:
     int rows, cols;
     int min_x, max_x, min_y, max_y;
-    uint64_t **matrix;
+    /* Физический буфер cap_rows x cap_cols, окно начинается с
+       (off_row, off_col). Все клетки вне окна равны нулю */
+    int cap_rows, cap_cols;
+    int off_row, off_col;
+    CellWidth cell_width;
+    uint8_t *cells;
+    uint8_t *back_cells;
+    int growth_count;
     bool save_bmp_flag;
 
     bool IsWithinBounds(int x, int y) const;
     void ClearOldMatrix();
+    void Allocate(int new_rows, int new_cols);
+    void Reallocate(int new_cap_rows, int new_cap_cols, int new_off_row,
+                    int new_off_col, CellWidth new_width);
+    void Widen(uint64_t value);
+    uint64_t GetCell(int row, int col) const;
+    void SetCell(int row, int col, uint64_t value);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,351 @@
+#include "../matrix/tiled_matrix.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/* Перемешивание координат плитки для хеш-таблицы (splitmix64) */
+uint64_t HashTileKey(int tile_x, int tile_y) {
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(tile_x))
+                    << 32) |
+                   static_cast<uint32_t>(tile_y);
+    key += 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+const int kInitialTableCapacity = 64;
+
+}  // namespace
+
+TiledMatrix::TiledMatrix()
+    : table(new Tile *[kInitialTableCapacity]()),
+      table_capacity(kInitialTableCapacity),
+      tiles(new Tile *[kInitialTableCapacity / 2]),
+      tile_count(0),
+      active_tiles(new Tile *[kInitialTableCapacity / 2]),
+      active_count(0),
+      active_dirty(true),
+      epoch(0),
+      min_x(0),
+      max_x(0),
+      min_y(0),
+      max_y(0) {}
+
+TiledMatrix::~TiledMatrix() {
+    Clear();
+    delete[] table;
+    delete[] tiles;
+    delete[] active_tiles;
+}
+
+void TiledMatrix::Clear() {
+    for (int i = 0; i < tile_count; ++i) {
+        delete[] tiles[i]->spill;
+        delete tiles[i];
+    }
+    for (int i = 0; i < table_capacity; ++i) {
+        table[i] = nullptr;
+    }
+    tile_count = 0;
+    active_count = 0;
+    active_dirty = true;
+}
+
+void TiledMatrix::AddGrains(int x, int y, uint64_t grains) {
+    Tile *tile = GetOrCreateTile(x >> kTileShift, y >> kTileShift);
+    tile->cells[(y & (kTileSize - 1)) * kTileSize + (x & (kTileSize - 1))] +=
+        grains;
+    IncludeCell(x, y);
+    active_dirty = true;
+}
+
+uint64_t TiledMatrix::Get(int x, int y) const {
+    const Tile *tile = FindTile(x >> kTileShift, y >> kTileShift);
+    if (tile == nullptr) {
+        return 0;
+    }
+    return tile
+        ->cells[(y & (kTileSize - 1)) * kTileSize + (x & (kTileSize - 1))];
+}
+
+void TiledMatrix::Set(int x, int y, uint64_t grains) {
+    Tile *tile = GetOrCreateTile(x >> kTileShift, y >> kTileShift);
+    tile->cells[(y & (kTileSize - 1)) * kTileSize + (x & (kTileSize - 1))] =
+        grains;
+    IncludeCell(x, y);
+    active_dirty = true;
+}
+
+int TiledMatrix::GetWidth() const { return max_x - min_x + 1; }
+
+int TiledMatrix::GetHeight() const { return max_y - min_y + 1; }
+
+int TiledMatrix::GetMinX() const { return min_x; }
+
+int TiledMatrix::GetMinY() const { return min_y; }
+
+/* Вся сетка строками, как у плотной: отсутствующие плитки - нули */
+void TiledMatrix::PrintMatrix() const {
+    for (int y = min_y; y <= max_y; ++y) {
+        int local_y = y & (kTileSize - 1);
+        for (int x = min_x; x <= max_x;) {
+            const Tile *tile = FindTile(x >> kTileShift, y >> kTileShift);
+            int end = ((x >> kTileShift) + 1) << kTileShift;
+            if (end > max_x + 1) {
+                end = max_x + 1;
+            }
+            for (; x < end; ++x) {
+                std::cout << (tile == nullptr
+                                  ? 0
+                                  : tile->cells[local_y * kTileSize +
+                                                (x & (kTileSize - 1))])
+                          << " ";
+            }
+        }
+        std::cout << '\n';
+    }
+    std::cout << std::flush;
+}
+
+/* Шаг в две фазы, чтобы он оставался синхронным:
+   1) каждая активная плитка считает, сколько отдаёт каждая клетка;
+   2) отданные песчинки добавляются соседям, в том числе в соседние
+      плитки (при необходимости они создаются) */
+void TiledMatrix::Topple() {
+    if (active_dirty) {
+        RebuildActiveTiles();
+    }
+
+    for (int t = 0; t < active_count; ++t) {
+        Tile *tile = active_tiles[t];
+        if (tile->spill == nullptr) {
+            tile->spill = new uint64_t[kTileCells];
+        }
+        int min_row = kTileSize, max_row = -1;
+        int min_col = kTileSize, max_col = -1;
+        for (int r = 0; r < kTileSize; ++r) {
+            uint64_t row_spill = 0;
+            for (int c = 0; c < kTileSize; ++c) {
+                int i = r * kTileSize + c;
+                uint64_t spill = tile->cells[i] >> 2;
+                tile->spill[i] = spill;
+                tile->cells[i] &= 3;
+                row_spill |= spill;
+                if (spill != 0) {
+                    min_col = c < min_col ? c : min_col;
+                    max_col = c > max_col ? c : max_col;
+                }
+            }
+            if (row_spill != 0) {
+                min_row = r < min_row ? r : min_row;
+                max_row = r;
+            }
+        }
+        int base_x = tile->tile_x << kTileShift;
+        int base_y = tile->tile_y << kTileShift;
+        IncludeCell(base_x + min_col - 1, base_y + min_row - 1);
+        IncludeCell(base_x + max_col + 1, base_y + max_row + 1);
+    }
+
+    for (int t = 0; t < active_count; ++t) {
+        Tile *tile = active_tiles[t];
+        const uint64_t *spill = tile->spill;
+        uint64_t *cells = tile->cells;
+        for (int r = 0; r < kTileSize; ++r) {
+            uint64_t *row = cells + r * kTileSize;
+            const uint64_t *from = spill + r * kTileSize;
+            for (int c = 0; c + 1 < kTileSize; ++c) {
+                row[c] += from[c + 1];  // От соседа справа
+            }
+            for (int c = 1; c < kTileSize; ++c) {
+                row[c] += from[c - 1];  // От соседа слева
+            }
+        }
+        for (int i = 0; i < kTileCells - kTileSize; ++i) {
+            cells[i] += spill[i + kTileSize];  // От соседа снизу
+        }
+        for (int i = kTileSize; i < kTileCells; ++i) {
+            cells[i] += spill[i - kTileSize];  // От соседа сверху
+        }
+
+        SpillIntoNeighbour(tile, -1, 0);
+        SpillIntoNeighbour(tile, 1, 0);
+        SpillIntoNeighbour(tile, 0, -1);
+        SpillIntoNeighbour(tile, 0, 1);
+    }
+
+    /* Неустойчивыми могут стать только осыпавшиеся плитки и их соседи */
+    ++epoch;
+    int previous_count = active_count;
+    Tile **candidates = new Tile *[previous_count * 5];
+    int candidate_count = 0;
+    for (int t = 0; t < previous_count; ++t) {
+        Tile *tile = active_tiles[t];
+        const int dx[] = {0, -1, 1, 0, 0};
+        const int dy[] = {0, 0, 0, -1, 1};
+        for (int k = 0; k < 5; ++k) {
+            Tile *candidate =
+                FindTile(tile->tile_x + dx[k], tile->tile_y + dy[k]);
+            if (candidate != nullptr && candidate->mark != epoch) {
+                candidate->mark = epoch;
+                candidates[candidate_count++] = candidate;
+            }
+        }
+    }
+    active_count = 0;
+    for (int i = 0; i < candidate_count; ++i) {
+        candidates[i]->active = IsTileUnstable(candidates[i]);
+        if (candidates[i]->active) {
+            active_tiles[active_count++] = candidates[i];
+        }
+    }
+    delete[] candidates;
+}
+
+bool TiledMatrix::HasUnstableCells() {
+    if (active_dirty) {
+        RebuildActiveTiles();
+    }
+    return active_count > 0;
+}
+
+void TiledMatrix::CopyFrom(const TiledMatrix &other) {
+    Clear();
+    for (int i = 0; i < other.tile_count; ++i) {
+        const Tile *source = other.tiles[i];
+        Tile *tile = GetOrCreateTile(source->tile_x, source->tile_y);
+        std::memcpy(tile->cells, source->cells, sizeof(tile->cells));
+    }
+    min_x = other.min_x;
+    max_x = other.max_x;
+    min_y = other.min_y;
+    max_y = other.max_y;
+}
+
+int TiledMatrix::GetTileCount() const { return tile_count; }
+
+const uint64_t *TiledMatrix::GetTileCells(int tile_x, int tile_y) const {
+    const Tile *tile = FindTile(tile_x, tile_y);
+    return tile != nullptr ? tile->cells : nullptr;
+}
+
+TiledMatrix::Tile *TiledMatrix::FindTile(int tile_x, int tile_y) const {
+    uint64_t mask = static_cast<uint64_t>(table_capacity) - 1;
+    uint64_t slot = HashTileKey(tile_x, tile_y) & mask;
+    while (table[slot] != nullptr) {
+        if (table[slot]->tile_x == tile_x && table[slot]->tile_y == tile_y) {
+            return table[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
+
+TiledMatrix::Tile *TiledMatrix::GetOrCreateTile(int tile_x, int tile_y) {
+    Tile *tile = FindTile(tile_x, tile_y);
+    if (tile != nullptr) {
+        return tile;
+    }
+
+    if ((tile_count + 1) * 2 > table_capacity) {
+        GrowTable();
+    }
+    tile = new Tile();
+    tile->tile_x = tile_x;
+    tile->tile_y = tile_y;
+    tile->spill = nullptr;
+    tile->active = false;
+    tile->mark = 0;
+    InsertIntoTable(tile);
+    tiles[tile_count++] = tile;
+    return tile;
+}
+
+void TiledMatrix::InsertIntoTable(Tile *tile) {
+    uint64_t mask = static_cast<uint64_t>(table_capacity) - 1;
+    uint64_t slot = HashTileKey(tile->tile_x, tile->tile_y) & mask;
+    while (table[slot] != nullptr) {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = tile;
+}
+
+/* Таблица заполнена не больше чем наполовину; при росте удваиваются
+   таблица, список плиток и список активных плиток */
+void TiledMatrix::GrowTable() {
+    delete[] table;
+    table_capacity *= 2;
+    table = new Tile *[table_capacity]();
+
+    Tile **new_tiles = new Tile *[table_capacity / 2];
+    Tile **new_active = new Tile *[table_capacity / 2];
+    for (int i = 0; i < tile_count; ++i) {
+        new_tiles[i] = tiles[i];
+        InsertIntoTable(tiles[i]);
+    }
+    for (int i = 0; i < active_count; ++i) {
+        new_active[i] = active_tiles[i];
+    }
+    delete[] tiles;
+    delete[] active_tiles;
+    tiles = new_tiles;
+    active_tiles = new_active;
+}
+
+void TiledMatrix::IncludeCell(int x, int y) {
+    min_x = x < min_x ? x : min_x;
+    max_x = x > max_x ? x : max_x;
+    min_y = y < min_y ? y : min_y;
+    max_y = y > max_y ? y : max_y;
+}
+
+void TiledMatrix::RebuildActiveTiles() {
+    active_count = 0;
+    for (int i = 0; i < tile_count; ++i) {
+        tiles[i]->active = IsTileUnstable(tiles[i]);
+        if (tiles[i]->active) {
+            active_tiles[active_count++] = tiles[i];
+        }
+    }
+    active_dirty = false;
+}
+
+/* Песчинки с края плитки уходят в крайний столбец/строку соседней */
+void TiledMatrix::SpillIntoNeighbour(Tile *tile, int dx, int dy) {
+    const int last = kTileSize - 1;
+    int from_start = 0, to_start = 0, step = 0;
+    if (dx != 0) {
+        from_start = dx < 0 ? 0 : last;  // Крайний столбец
+        to_start = dx < 0 ? last : 0;
+        step = kTileSize;
+    } else {
+        from_start = dy < 0 ? 0 : last * kTileSize;  // Крайняя строка
+        to_start = dy < 0 ? last * kTileSize : 0;
+        step = 1;
+    }
+
+    uint64_t any = 0;
+    for (int k = 0; k < kTileSize; ++k) {
+        any |= tile->spill[from_start + k * step];
+    }
+    if (any == 0) {
+        return;
+    }
+
+    Tile *neighbour = GetOrCreateTile(tile->tile_x + dx, tile->tile_y + dy);
+    for (int k = 0; k < kTileSize; ++k) {
+        neighbour->cells[to_start + k * step] +=
+            tile->spill[from_start + k * step];
+    }
+}
+
+bool TiledMatrix::IsTileUnstable(const Tile *tile) const {
+    uint64_t acc = 0;
+    for (int i = 0; i < kTileCells; ++i) {
+        acc |= tile->cells[i] >> 2;
+    }
+    return acc != 0;
+}
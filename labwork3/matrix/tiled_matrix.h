@@ -0,0 +1,74 @@
+#ifndef TILED_MATRIX_H
+#define TILED_MATRIX_H
+
+#include <cstdint>
+
+/* Разреженная сетка: клетки хранятся плитками 64x64, плитки лежат в
+   хеш-таблице по координатам плитки. Память выделяется только под
+   плитки, в которые попали песчинки, поэтому далёкие друг от друга
+   клетки не требуют огромного плотного прямоугольника.
+   Шаг осыпания обходит только плитки с неустойчивыми клетками */
+class TiledMatrix {
+   public:
+    static const int kTileShift = 6;
+    static const int kTileSize = 1 << kTileShift;  // 64
+    static const int kTileCells = kTileSize * kTileSize;
+
+    TiledMatrix();
+    ~TiledMatrix();
+    TiledMatrix(const TiledMatrix &) = delete;
+    TiledMatrix &operator=(const TiledMatrix &) = delete;
+
+    void AddGrains(int x, int y, uint64_t grains);
+    uint64_t Get(int x, int y) const;
+    void Set(int x, int y, uint64_t grains);
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetMinX() const;
+    int GetMinY() const;
+    void PrintMatrix() const;  // Так же, как DynamicMatrix::PrintMatrix
+
+    void Topple();  // Один синхронный шаг осыпания
+    bool HasUnstableCells();
+    void CopyFrom(const TiledMatrix &other);
+
+    int GetTileCount() const;
+    /* Клетки плитки (строками по kTileSize) или nullptr, если плитки нет.
+       tile_x, tile_y - координаты плитки: x >> kTileShift */
+    const uint64_t *GetTileCells(int tile_x, int tile_y) const;
+
+   private:
+    struct Tile {
+        int tile_x, tile_y;
+        uint64_t cells[kTileCells];
+        uint64_t *spill;  // Сколько песчинок клетка отдаёт каждому соседу
+        bool active;      // Есть клетки с 4+ песчинками
+        uint32_t mark;    // Для обхода без повторов
+    };
+
+    /* Хеш-таблица с открытой адресацией: ключ - координаты плитки */
+    Tile **table;
+    int table_capacity;
+    Tile **tiles;  // Все плитки подряд, для обхода (не больше половины
+                   // ёмкости таблицы)
+    int tile_count;
+
+    Tile **active_tiles;  // Плитки, которые осыпаются на текущем шаге
+    int active_count;
+    bool active_dirty;  // Список активных плиток нужно пересобрать
+    uint32_t epoch;
+
+    int min_x, max_x, min_y, max_y;
+
+    Tile *FindTile(int tile_x, int tile_y) const;
+    Tile *GetOrCreateTile(int tile_x, int tile_y);
+    void InsertIntoTable(Tile *tile);
+    void GrowTable();
+    void Clear();
+    void IncludeCell(int x, int y);
+    void RebuildActiveTiles();
+    void SpillIntoNeighbour(Tile *tile, int dx, int dy);
+    bool IsTileUnstable(const Tile *tile) const;
+};
+
+#endif  // TILED_MATRIX_H
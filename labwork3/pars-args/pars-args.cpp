@@ -4,7 +4,10 @@
 
 /* Парсер аргументов командной строки */
 void ParsArgs(int argc, char **argv, const char *&filename,
-              const char *&output_file, int &max_iter, int &freq) {
+              const char *&output_file, int &max_iter, int &freq,
+              const char *&container_file, bool &sparse,
+              const char *&checkpoint_file, int &checkpoint_freq,
+              const char *&resume_file) {
     for (int i = 1; i < argc; ++i) {
         /* Ввод .tsv файла */
         if (std::strncmp(argv[i], "-i", 2) == 0) {
@@ -49,5 +52,27 @@ void ParsArgs(int argc, char **argv, const char *&filename,
 
             freq = StrToInt(freq_char);
         }
+
+        /* Все кадры в одном файле-контейнере вместо отдельных BMP */
+        if (std::strncmp(argv[i], "--container", 11) == 0) {
+            container_file = argv[i] + 12;
+        }
+
+        /* Разреженная сетка плитками для далёких друг от друга клеток */
+        if (std::strcmp(argv[i], "--sparse") == 0) {
+            sparse = true;
+        }
+
+        /* Контрольные точки: файл и частота сохранения в итерациях */
+        if (std::strncmp(argv[i], "--checkpoint-freq", 17) == 0) {
+            checkpoint_freq = StrToInt(argv[i] + 18);
+        } else if (std::strncmp(argv[i], "--checkpoint", 12) == 0) {
+            checkpoint_file = argv[i] + 13;
+        }
+
+        /* Продолжение симуляции с контрольной точки */
+        if (std::strncmp(argv[i], "--resume", 8) == 0) {
+            resume_file = argv[i] + 9;
+        }
     }
 }
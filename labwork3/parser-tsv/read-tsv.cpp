@@ -57,9 +57,5 @@ void ParsTSVFile(char* str, log_s& logs) {
     logs.height = StrToInt(buffer_y);
     logs.count = StrToUint64(buffer_count);
 
-    /* Добавьте дополнительные проверки, если необходимо */
-    if (logs.width < 0 || logs.height < 0 || logs.count < 0) {
-        std::cerr << "Error: Invalid dimensions or grain count." << std::endl;
-        return;
-    }
+    /* Координаты могут быть отрицательными: сетка растёт в любую сторону */
 }
@@ -0,0 +1,180 @@
+#include "../parser-tsv/tsv_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <climits>
+#include <iostream>
+
+namespace {
+
+/* Самая короткая непустая строка - "0 0 0\n", поэтому клеток в файле
+   не больше, чем size / kMinLineLength + 1 */
+const size_t kMinLineLength = 6;
+
+/* Разделители полей: табуляция или пробелы */
+const char *SkipBlanks(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+/* Число без знака прямо из отображённого файла, без копирования поля */
+const char *ParseDigits(const char *p, const char *end, uint64_t &value,
+                        bool &ok) {
+    const char *start = p;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        uint64_t digit = static_cast<uint64_t>(*p - '0');
+        if (value > UINT64_MAX / 10 ||
+            (value == UINT64_MAX / 10 && digit > UINT64_MAX % 10)) {
+            ok = false;  // Не помещается в uint64_t
+        }
+        value = value * 10 + digit;
+        ++p;
+    }
+    if (p == start) {
+        ok = false;
+    }
+    return p;
+}
+
+const char *ParseCoordinate(const char *p, const char *end, int &value,
+                            bool &ok) {
+    bool negative = p < end && *p == '-';
+    if (negative) {
+        ++p;
+    }
+    uint64_t magnitude;
+    p = ParseDigits(p, end, magnitude, ok);
+    if (magnitude > static_cast<uint64_t>(INT_MAX)) {
+        ok = false;
+    }
+    value = negative ? -static_cast<int>(magnitude)
+                     : static_cast<int>(magnitude);
+    return p;
+}
+
+}  // namespace
+
+TSVLoader::TSVLoader()
+    : cells(nullptr),
+      cell_count(0),
+      min_x(0),
+      max_x(0),
+      min_y(0),
+      max_y(0),
+      max_count(0) {}
+
+TSVLoader::~TSVLoader() { delete[] cells; }
+
+bool TSVLoader::Load(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "File could not be opened" << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "File could not be read" << std::endl;
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {  // Пустой файл - пустая сетка
+        close(fd);
+        return true;
+    }
+
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "File could not be mapped" << std::endl;
+        return false;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    /* Массив выделяется один раз по верхней оценке; неиспользованный
+       хвост не трогается и физической памяти не занимает */
+    delete[] cells;
+    cells = new TSV_cell[size / kMinLineLength + 1];
+    cell_count = 0;
+
+    const char *data = static_cast<const char *>(mapped);
+    bool parsed = Parse(data, data + size);
+    munmap(mapped, size);
+    return parsed;
+}
+
+/* Строка: x, y, количество песчинок. Пустые строки пропускаются */
+bool TSVLoader::Parse(const char *data, const char *end) {
+    int line = 1;
+    const char *p = data;
+    while (p < end) {
+        p = SkipBlanks(p, end);
+        if (p < end && *p == '\n') {
+            ++p;
+            ++line;
+            continue;
+        }
+        if (p == end) {
+            break;
+        }
+
+        bool ok = true;
+        int x, y;
+        uint64_t count;
+        p = ParseCoordinate(p, end, x, ok);
+        p = SkipBlanks(p, end);
+        p = ParseCoordinate(p, end, y, ok);
+        p = SkipBlanks(p, end);
+        p = ParseDigits(p, end, count, ok);
+        p = SkipBlanks(p, end);
+        if (!ok || (p < end && *p != '\n')) {
+            std::cerr << "Invalid TSV line " << line << std::endl;
+            return false;
+        }
+        Push(x, y, count);
+    }
+    return true;
+}
+
+void TSVLoader::Push(int x, int y, uint64_t count) {
+    cells[cell_count++] = {x, y, count};
+
+    min_x = x < min_x ? x : min_x;
+    max_x = x > max_x ? x : max_x;
+    min_y = y < min_y ? y : min_y;
+    max_y = y > max_y ? y : max_y;
+    max_count = count > max_count ? count : max_count;
+}
+
+int TSVLoader::GetCellCount() const { return cell_count; }
+
+const TSV_cell *TSVLoader::GetCells() const { return cells; }
+
+int TSVLoader::GetMinX() const { return min_x; }
+
+int TSVLoader::GetMinY() const { return min_y; }
+
+int TSVLoader::GetMaxX() const { return max_x; }
+
+int TSVLoader::GetMaxY() const { return max_y; }
+
+/* Окно выделяется сразу под весь прямоугольник; AddGrains внутри него
+   не расширяет сетку и только при повторах клетки может расширить тип */
+void TSVLoader::Fill(DynamicMatrix &matrix) const {
+    matrix.Reset(min_x, min_y, max_x, max_y, max_count);
+    for (int i = 0; i < cell_count; ++i) {
+        matrix.AddGrains(cells[i].x, cells[i].y, cells[i].count);
+    }
+}
+
+void TSVLoader::Fill(TiledMatrix &matrix) const {
+    for (int i = 0; i < cell_count; ++i) {
+        matrix.AddGrains(cells[i].x, cells[i].y, cells[i].count);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TSV_LOADER_H
+#define TSV_LOADER_H
+
+#include <cstdint>
+
+#include "../matrix/matrix.h"
+#include "../matrix/tiled_matrix.h"
+
+/* Одна строка входного файла */
+struct TSV_cell {
+    int x;
+    int y;
+    uint64_t count;
+};
+
+/* Загрузка начального состояния целиком: файл отображается в память и
+   разбирается за один проход в массив клеток, попутно считается
+   ограничивающий прямоугольник. Затем сетка выделяется один раз и
+   песчинки раскладываются по клеткам без расширений по одной клетке */
+class TSVLoader {
+   public:
+    TSVLoader();
+    ~TSVLoader();
+    TSVLoader(const TSVLoader &) = delete;
+    TSVLoader &operator=(const TSVLoader &) = delete;
+
+    bool Load(const char *filename);
+
+    int GetCellCount() const;
+    const TSV_cell *GetCells() const;
+    /* Прямоугольник всегда содержит начало координат, как и сетка,
+       которая растёт из клетки (0, 0) */
+    int GetMinX() const;
+    int GetMinY() const;
+    int GetMaxX() const;
+    int GetMaxY() const;
+
+    void Fill(DynamicMatrix &matrix) const;
+    void Fill(TiledMatrix &matrix) const;
+
+   private:
+    TSV_cell *cells;
+    int cell_count;
+    int min_x, max_x, min_y, max_y;
+    uint64_t max_count;  // Самая большая строка, для выбора ширины клетки
+
+    void Push(int x, int y, uint64_t count);
+    bool Parse(const char *data, const char *end);
+};
+
+#endif  // TSV_LOADER_H
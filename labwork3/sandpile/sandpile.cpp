@@ -1,42 +1,74 @@
 #include "../sandpile/sandpile.h"
-#include "../bmp/bmp_writer.h"
+#include "../stencil/stencil.h"
 #include <iostream>
 
 
-Sandpile::Sandpile(DynamicMatrix& matrix) : matrix(matrix) {}
+Sandpile::Sandpile(DynamicMatrix& matrix)
+    : matrix(&matrix), tiled(nullptr), toppled(false), unstable(false) {}
 
+Sandpile::Sandpile(TiledMatrix& matrix)
+    : matrix(nullptr), tiled(&matrix), toppled(false), unstable(false) {}
+
+/* Один синхронный шаг: все клетки с 4+ песчинками осыпаются одновременно,
+   новое состояние зависит только от предыдущего */
 void Sandpile::Topple() {
-    for (int i = matrix.GetMinY(); i <= matrix.GetHeight(); ++i) {
-        for (int j = matrix.GetMinX(); j <= matrix.GetWidth(); ++j) {
-            if (matrix.Get(j, i) >= 4) {
-                uint64_t p_grains = matrix.Get(j, i) / 4;
-                matrix.Set(j, i, matrix.Get(j, i) % 4);
-
-                // Проверяем необходимость расширения для каждой стороны
-                if (j + 1 > matrix.GetWidth())
-                    matrix.Expand(j + 1, i);  // Право
-                if (j - 1 < matrix.GetMinX()) matrix.Expand(j - 1, i);  // Лево
-                if (i + 1 > matrix.GetHeight())
-                    matrix.Expand(j, i + 1);  // Вниз
-                if (i - 1 < matrix.GetMinY()) matrix.Expand(j, i - 1);  // Вверх
-
-                // Распределяем песчинки по соседним ячейкам
-                matrix.AddGrains(j + 1, i, p_grains);  // Право
-                matrix.AddGrains(j - 1, i, p_grains);  // Лево
-                matrix.AddGrains(j, i + 1, p_grains);  // Вниз
-                matrix.AddGrains(j, i - 1, p_grains);  // Вверх
-            }
-        }
+    Expand();
+    Step();
+}
+
+/* Разреженная сетка заводит тайлы сама во время шага */
+void Sandpile::Expand() {
+    if (tiled == nullptr) {
+        ExpandForUnstableEdges();
     }
 }
 
+void Sandpile::Step() {
+    if (tiled != nullptr) {
+        tiled->Topple();
+        unstable = tiled->HasUnstableCells();
+        toppled = true;
+        return;
+    }
+
+    int rows = matrix->GetHeight();
+    unstable = RunStencil(matrix->GetCellWidth(), matrix->GetRow(0),
+                          matrix->GetBackRow(0), rows, matrix->GetWidth(),
+                          matrix->GetStride());
+    matrix->SwapBuffers();
+    toppled = true;
+}
+
 bool Sandpile::IsStable() const {
-    for (int y = matrix.GetMinY(); y <= matrix.GetHeight(); ++y) {
-        for (int x = matrix.GetMinX(); x <= matrix.GetWidth(); ++x) {
-            if (matrix.Get(x, y) > 3) {
-                return false;
-            }
-        }
+    if (toppled) {
+        return !unstable;
     }
-    return true;
+    if (tiled != nullptr) {
+        return !tiled->HasUnstableCells();
+    }
+    return !matrix->HasUnstableCells();
+}
+
+/* Если песчинки с края осыпятся за границу, заранее расширяем сетку
+   в эту сторону */
+void Sandpile::ExpandForUnstableEdges() {
+    int min_x = matrix->GetMinX();
+    int min_y = matrix->GetMinY();
+    int max_x = min_x + matrix->GetWidth() - 1;
+    int max_y = min_y + matrix->GetHeight() - 1;
+    bool left = false, right = false, up = false, down = false;
+
+    for (int x = min_x; x <= max_x; ++x) {
+        up = up || matrix->Get(x, min_y) >= 4;
+        down = down || matrix->Get(x, max_y) >= 4;
+    }
+    for (int y = min_y; y <= max_y; ++y) {
+        left = left || matrix->Get(min_x, y) >= 4;
+        right = right || matrix->Get(max_x, y) >= 4;
+    }
+
+    if (left) matrix->ExpandLeft();    // Лево
+    if (right) matrix->ExpandRight();  // Право
+    if (up) matrix->ExpandUp();        // Вверх
+    if (down) matrix->ExpandDown();    // Вниз
 }
@@ -1,13 +1,22 @@
 #pragma once
 #include "../matrix/matrix.h"
+#include "../matrix/tiled_matrix.h"
 
 class Sandpile {
    public:
     Sandpile(DynamicMatrix& matrix);
-    void Topple();
+    Sandpile(TiledMatrix& matrix);  // Разреженная сетка (--sparse)
+    void Topple();  // Expand и Step подряд
+    // Половины шага, чтобы замерять их по отдельности
+    void Expand();  // Расширяет сетку под неустойчивые края
+    void Step();
     bool IsStable() const;
 
    private:
-    DynamicMatrix& matrix;
-};
+    DynamicMatrix* matrix;  // Ровно один из указателей не nullptr
+    TiledMatrix* tiled;
+    bool toppled;   // Был ли выполнен хотя бы один шаг
+    bool unstable;  // Остались ли неустойчивые клетки после шага
 
+    void ExpandForUnstableEdges();
+};
@@ -0,0 +1,187 @@
+#include "../stencil/stencil.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STENCIL_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/* Скалярное ядро: тот же шаг, что и векторный, по одной клетке */
+template <typename T>
+T ScalarRow(const T *src, T *dst, int from, int to, int stride) {
+    T unstable = 0;
+    for (int i = from; i < to; ++i) {
+        T value = (src[i] & 3) + (src[i - 1] >> 2) + (src[i + 1] >> 2) +
+                  (src[i - stride] >> 2) + (src[i + stride] >> 2);
+        dst[i] = value;
+        unstable |= value >> 2;
+    }
+    return unstable;
+}
+
+template <typename T>
+bool ScalarStencil(const void *src, void *dst, int rows, int cols,
+                   int stride) {
+    const T *in = static_cast<const T *>(src);
+    T *out = static_cast<T *>(dst);
+    T unstable = 0;
+    for (int r = 0; r < rows; ++r) {
+        int64_t shift = static_cast<int64_t>(r) * stride;
+        unstable |= ScalarRow(in + shift, out + shift, 0, cols, stride);
+    }
+    return unstable != 0;
+}
+
+#ifdef STENCIL_HAS_AVX2
+
+/* Операции AVX2 для каждой ширины клетки */
+template <typename T>
+struct Avx2Ops;
+
+template <>
+struct Avx2Ops<uint16_t> {
+    __attribute__((target("avx2"))) static __m256i Set1(uint16_t v) {
+        return _mm256_set1_epi16(static_cast<short>(v));
+    }
+    __attribute__((target("avx2"))) static __m256i Add(__m256i a, __m256i b) {
+        return _mm256_add_epi16(a, b);
+    }
+    __attribute__((target("avx2"))) static __m256i Quarter(__m256i a) {
+        return _mm256_srli_epi16(a, 2);
+    }
+};
+
+template <>
+struct Avx2Ops<uint32_t> {
+    __attribute__((target("avx2"))) static __m256i Set1(uint32_t v) {
+        return _mm256_set1_epi32(static_cast<int>(v));
+    }
+    __attribute__((target("avx2"))) static __m256i Add(__m256i a, __m256i b) {
+        return _mm256_add_epi32(a, b);
+    }
+    __attribute__((target("avx2"))) static __m256i Quarter(__m256i a) {
+        return _mm256_srli_epi32(a, 2);
+    }
+};
+
+template <>
+struct Avx2Ops<uint64_t> {
+    __attribute__((target("avx2"))) static __m256i Set1(uint64_t v) {
+        return _mm256_set1_epi64x(static_cast<long long>(v));
+    }
+    __attribute__((target("avx2"))) static __m256i Add(__m256i a, __m256i b) {
+        return _mm256_add_epi64(a, b);
+    }
+    __attribute__((target("avx2"))) static __m256i Quarter(__m256i a) {
+        return _mm256_srli_epi64(a, 2);
+    }
+};
+
+template <typename T>
+__attribute__((target("avx2"))) __m256i LoadCells(const T *ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+}
+
+/* Векторное ядро: 32 байта клеток за итерацию, хвост строки скалярно */
+template <typename T>
+__attribute__((target("avx2"))) bool Avx2Stencil(const void *src, void *dst,
+                                                 int rows, int cols,
+                                                 int stride) {
+    using Ops = Avx2Ops<T>;
+    constexpr int kLanes = 32 / sizeof(T);
+    const T *in = static_cast<const T *>(src);
+    T *out = static_cast<T *>(dst);
+    const __m256i three = Ops::Set1(3);
+    __m256i acc = _mm256_setzero_si256();
+    T tail_unstable = 0;
+
+    for (int r = 0; r < rows; ++r) {
+        int64_t shift = static_cast<int64_t>(r) * stride;
+        const T *row = in + shift;
+        T *dst_row = out + shift;
+        int i = 0;
+        for (; i + kLanes <= cols; i += kLanes) {
+            __m256i center = LoadCells(row + i);
+            __m256i left = LoadCells(row + i - 1);
+            __m256i right = LoadCells(row + i + 1);
+            __m256i up = LoadCells(row + i - stride);
+            __m256i down = LoadCells(row + i + stride);
+
+            __m256i value = Ops::Add(
+                _mm256_and_si256(center, three),
+                Ops::Add(Ops::Add(Ops::Quarter(left), Ops::Quarter(right)),
+                         Ops::Add(Ops::Quarter(up), Ops::Quarter(down))));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst_row + i),
+                                value);
+            acc = _mm256_or_si256(acc, Ops::Quarter(value));
+        }
+        tail_unstable |= ScalarRow(row, dst_row, i, cols, stride);
+    }
+    return !_mm256_testz_si256(acc, acc) || tail_unstable != 0;
+}
+
+#endif  // STENCIL_HAS_AVX2
+
+using StencilKernel = bool (*)(const void *, void *, int, int, int);
+
+bool IsAvx2Supported() {
+#ifdef STENCIL_HAS_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+StencilBackend current_backend = StencilBackend::kAuto;
+
+StencilBackend ResolveBackend() {
+    if (current_backend == StencilBackend::kAuto) {
+        current_backend =
+            IsAvx2Supported() ? StencilBackend::kAVX2 : StencilBackend::kScalar;
+    }
+    return current_backend;
+}
+
+StencilKernel SelectKernel(CellWidth width) {
+#ifdef STENCIL_HAS_AVX2
+    if (ResolveBackend() == StencilBackend::kAVX2) {
+        switch (width) {
+            case CellWidth::k16:
+                return Avx2Stencil<uint16_t>;
+            case CellWidth::k32:
+                return Avx2Stencil<uint32_t>;
+            case CellWidth::k64:
+                return Avx2Stencil<uint64_t>;
+        }
+    }
+#endif
+    switch (width) {
+        case CellWidth::k16:
+            return ScalarStencil<uint16_t>;
+        case CellWidth::k32:
+            return ScalarStencil<uint32_t>;
+        default:
+            return ScalarStencil<uint64_t>;
+    }
+}
+
+}  // namespace
+
+bool RunStencil(CellWidth width, const void *src, void *dst, int rows,
+                int cols, int stride) {
+    return SelectKernel(width)(src, dst, rows, cols, stride);
+}
+
+void SetStencilBackend(StencilBackend backend) {
+    if (backend == StencilBackend::kAVX2 && !IsAvx2Supported()) {
+        backend = StencilBackend::kScalar;
+    }
+    current_backend = backend;
+}
+
+StencilBackend GetStencilBackend() { return ResolveBackend(); }
+
+const char *GetStencilBackendName() {
+    return ResolveBackend() == StencilBackend::kAVX2 ? "avx2" : "scalar";
+}
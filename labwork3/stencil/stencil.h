@@ -0,0 +1,23 @@
+#ifndef STENCIL_H
+#define STENCIL_H
+
+#include <cstdint>
+
+#include "../matrix/matrix.h"
+
+/* Реализация ядра осыпания */
+enum class StencilBackend { kAuto, kScalar, kAVX2 };
+
+/* Один синхронный шаг осыпания для окна rows x cols:
+       dst = (src & 3) + (left >> 2) + (right >> 2) + (up >> 2) + (down >> 2)
+   Вокруг окна должна быть нулевая рамка (см. DynamicMatrix::GetRow).
+   Возвращает true, если после шага остались клетки с 4+ песчинками */
+bool RunStencil(CellWidth width, const void *src, void *dst, int rows,
+                int cols, int stride);
+
+/* Выбор реализации: по умолчанию AVX2, если процессор его поддерживает */
+void SetStencilBackend(StencilBackend backend);
+StencilBackend GetStencilBackend();
+const char *GetStencilBackendName();
+
+#endif  // STENCIL_H
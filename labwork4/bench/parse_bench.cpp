@@ -0,0 +1,189 @@
+// Parse latency benchmark:
+//   startup - build a typical schema and parse a short command line,
+//             averaged over many runs (what every process start pays)
+//   static  - the same schema and command line through StaticArgParser
+//   bulk    - one positional multi-value argument fed with N integers,
+//             as produced by xargs
+//   lookup  - N options spread over 64 registered names of mixed kinds
+//             (int and string "--name=value", flags "--name")
+//   response - the bulk list read from an "@file" response file
+//
+// Usage: parse_bench [N] [startup runs]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../lib/ArgParser/ArgParser.h"
+#include "../lib/StaticParser/StaticParser.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+bool ParseStartup(int argc, char** argv) {
+    ArgParser parser("Bench");
+    std::vector<int> values;
+    parser.AddHelp('h', "help", "Benchmark parser");
+    parser.AddStringArgument('i', "input", "Input file");
+    parser.AddStringArgument('o', "output", "Output file");
+    parser.AddIntArgument("number", "Some number");
+    parser.AddFlag('s', "sum", "Add values");
+    parser.AddFlag('m', "mult", "Multiply values");
+    parser.AddIntArgument("N").MultiValue(1).Positional().StoreValues(values);
+    return parser.Parse(argc, argv);
+}
+
+using StartupParser =
+    StaticArgParser<FlagOption<"help", 'h'>, StringOption<"input", 'i'>,
+                    StringOption<"output", 'o'>, IntOption<"number">,
+                    FlagOption<"sum", 's'>, FlagOption<"mult", 'm'>,
+                    PositionalInts<"N", 1>>;
+
+bool ParseStartupStatic(int argc, char** argv) {
+    StartupParser::Result result;
+    return StartupParser::Parse(argc, argv, result);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+    // Short command line
+    std::vector<std::string> short_args = {
+        "app", "--input=in.txt", "-o", "out.txt", "--number=42", "-s",
+        "1",   "2",              "3"};
+    std::vector<char*> short_argv;
+    for (auto& arg : short_args) {
+        short_argv.push_back(arg.data());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        if (!ParseStartup(static_cast<int>(short_argv.size()),
+                          short_argv.data())) {
+            std::cerr << "startup parse failed" << std::endl;
+            return 1;
+        }
+    }
+    double startup = SecondsSince(start);
+    std::cout << "startup\t" << startup / runs * 1e6 << " us per run"
+              << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        if (!ParseStartupStatic(static_cast<int>(short_argv.size()),
+                                short_argv.data())) {
+            std::cerr << "static parse failed" << std::endl;
+            return 1;
+        }
+    }
+    double startup_static = SecondsSince(start);
+    std::cout << "static\t" << startup_static / runs * 1e6 << " us per run"
+              << std::endl;
+
+    // Huge positional list
+    std::vector<std::string> bulk_args = {"app", "--sum"};
+    for (int i = 0; i < count; ++i) {
+        bulk_args.push_back(std::to_string(i));
+    }
+    std::vector<char*> bulk_argv;
+    for (auto& arg : bulk_args) {
+        bulk_argv.push_back(arg.data());
+    }
+
+    ArgParser parser("Bench");
+    std::vector<int> values;
+    parser.AddFlag("sum");
+    parser.AddIntArgument("N").MultiValue(1).Positional().StoreValues(values);
+
+    start = std::chrono::steady_clock::now();
+    bool parsed =
+        parser.Parse(static_cast<int>(bulk_argv.size()), bulk_argv.data());
+    double bulk = SecondsSince(start);
+    if (!parsed || values.size() != static_cast<size_t>(count)) {
+        std::cerr << "bulk parse failed" << std::endl;
+        return 1;
+    }
+    std::cout << "bulk\t" << count << " args\t" << bulk * 1000 << " ms\t"
+              << bulk / count * 1e9 << " ns per arg" << std::endl;
+
+    // Option lookups
+    const int kOptions = 64;
+    ArgParser lookup_parser("Bench");
+    for (int i = 0; i < kOptions; ++i) {
+        std::string name = "option" + std::to_string(i);
+        if (i % 3 == 0) {
+            lookup_parser.AddIntArgument(name);
+        } else if (i % 3 == 1) {
+            lookup_parser.AddStringArgument(name);
+        } else {
+            lookup_parser.AddFlag(name);
+        }
+    }
+    std::vector<std::string> lookup_args = {"app"};
+    for (int i = 0; i < count; ++i) {
+        int option = i % kOptions;
+        std::string arg = "--option" + std::to_string(option);
+        if (option % 3 != 2) {
+            arg += "=" + std::to_string(i % 1000);
+        }
+        lookup_args.push_back(arg);
+    }
+    std::vector<char*> lookup_argv;
+    for (auto& arg : lookup_args) {
+        lookup_argv.push_back(arg.data());
+    }
+
+    start = std::chrono::steady_clock::now();
+    parsed = lookup_parser.Parse(static_cast<int>(lookup_argv.size()),
+                                 lookup_argv.data());
+    double lookup = SecondsSince(start);
+    if (!parsed) {
+        std::cerr << "lookup parse failed" << std::endl;
+        return 1;
+    }
+    std::cout << "lookup\t" << count << " args\t" << lookup * 1000 << " ms\t"
+              << lookup / count * 1e9 << " ns per arg" << std::endl;
+
+    // Response file
+    const char* kResponsePath = "parse_bench.rsp";
+    {
+        std::ofstream response(kResponsePath);
+        for (int i = 0; i < count; ++i) {
+            response << i << '\n';
+        }
+    }
+    ArgParser response_parser("Bench");
+    std::vector<int> response_values;
+    response_parser.AddFlag("sum");
+    response_parser.AddIntArgument("N").MultiValue(1).Positional().StoreValues(
+        response_values);
+    std::vector<std::string> response_args = {"app", "--sum",
+                                              std::string("@") + kResponsePath};
+
+    start = std::chrono::steady_clock::now();
+    parsed = response_parser.Parse(response_args);
+    double response = SecondsSince(start);
+    std::remove(kResponsePath);
+    if (!parsed || response_values.size() != static_cast<size_t>(count)) {
+        std::cerr << "response parse failed" << std::endl;
+        return 1;
+    }
+    std::cout << "response\t" << count << " args\t" << response * 1000
+              << " ms\t" << response / count * 1e9 << " ns per arg"
+              << std::endl;
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "ArgParser.h"
 
 #include <iostream>
+#include <stdexcept>
 
 #include "../Functions/Functions.h"
 
@@ -8,6 +9,7 @@ namespace ArgumentParser {
 
 // Work with string
 Argument& ArgParser::AddStringArgument(const std::string& long_name) {
+    registry_dirty_ = true;
     auto& argument = string_arguments_[long_name];
     argument = Argument('\0', long_name);
     // Set as mandatory
@@ -23,6 +25,7 @@ Argument& ArgParser::AddStringArgument(const std::string& long_name) {
 
 Argument& ArgParser::AddStringArgument(char short_name,
                                        const std::string& long_name) {
+    registry_dirty_ = true;
     auto& argument = string_arguments_[long_name];
     argument = Argument(short_name, long_name);
     short_to_long_[short_name] = long_name;
@@ -34,6 +37,7 @@ Argument& ArgParser::AddStringArgument(char short_name,
 Argument& ArgParser::AddStringArgument(char short_name,
                                        const std::string& long_name,
                                        const std::string& description) {
+    registry_dirty_ = true;
     auto& argument = string_arguments_[long_name];
     argument = Argument(short_name, long_name);
     short_to_long_[short_name] = long_name;
@@ -45,6 +49,7 @@ Argument& ArgParser::AddStringArgument(char short_name,
 // Work with int
 
 Argument& ArgParser::AddIntArgument(const std::string& long_name) {
+    registry_dirty_ = true;
     auto& argument = int_arguments_[long_name];
     argument = Argument('\0', long_name);
     argument.SetRequired(true).SetIsInt(true);
@@ -53,6 +58,7 @@ Argument& ArgParser::AddIntArgument(const std::string& long_name) {
 
 Argument& ArgParser::AddIntArgument(const std::string& long_name,
                                     const std::string& description) {
+    registry_dirty_ = true;
     auto& argument = int_arguments_[long_name];
     argument = Argument('\0', long_name);
     argument.SetRequired(true).SetIsInt(true).SetDescription(description);
@@ -61,12 +67,10 @@ Argument& ArgParser::AddIntArgument(const std::string& long_name,
 
 Argument& ArgParser::AddIntArgument(char short_name,
                                     const std::string& long_name) {
+    registry_dirty_ = true;
     auto& argument = int_arguments_[long_name];
     argument = Argument(short_name, long_name);
     short_to_long_[short_name] = long_name;
-    std::cout << "Mapping short name " << short_name << " to " << long_name
-              << "\n";
-
     argument.SetRequired(true).SetIsInt(true);
     return argument;
 }
@@ -74,11 +78,9 @@ Argument& ArgParser::AddIntArgument(char short_name,
 Argument& ArgParser::AddIntArgument(char short_name,
                                     const std::string& long_name,
                                     const std::string& description) {
+    registry_dirty_ = true;
     auto& argument = int_arguments_[long_name];
     argument = Argument(short_name, long_name);
-    std::cout << "Mapping short name " << short_name << " to " << long_name
-              << "\n";
-
     short_to_long_[short_name] = long_name;
     argument.SetRequired(true).SetIsInt(true).SetDescription(description);
     return argument;
@@ -90,8 +92,8 @@ int ArgParser::GetIntValue(const std::string& name, int default_value) const {
         return default_value;
     }
     if (it->second.IsMultivalue()) {
-        if (!it->second.GetIntValues().empty()) {
-            return it->second.GetIntValues().front();
+        if (it->second.GetIntCount() > 0) {
+            return it->second.GetIntValueA();
         }
         throw std::runtime_error(
             "No values provided for multivalue argument: " + name);
@@ -100,6 +102,7 @@ int ArgParser::GetIntValue(const std::string& name, int default_value) const {
 }
 
 Argument& ArgParser::AddFlag(const std::string& long_name) {
+    registry_dirty_ = true;
     auto& argument = flag_arguments_[long_name];
     argument = Argument('\0', long_name);
     argument.SetAsFlag();
@@ -107,6 +110,7 @@ Argument& ArgParser::AddFlag(const std::string& long_name) {
 }
 
 Argument& ArgParser::AddFlag(char short_name, const std::string& long_name) {
+    registry_dirty_ = true;
     if (flag_arguments_.count(long_name)) {
         throw std::runtime_error("Flag already exists: " + long_name);
     }
@@ -119,6 +123,7 @@ Argument& ArgParser::AddFlag(char short_name, const std::string& long_name) {
 
 Argument& ArgParser::AddFlag(char short_name, const std::string& long_name,
                              const std::string& description) {
+    registry_dirty_ = true;
     if (flag_arguments_.count(long_name)) {
         throw std::runtime_error("Flag already exists: " + long_name);
     }
@@ -139,6 +144,7 @@ bool ArgParser::GetFlag(const std::string& name) const {
 
 Argument& ArgParser::AddHelp(char short_name, const std::string& long_name,
                              const std::string description) {
+    registry_dirty_ = true;
     help_arguments_[long_name] = Argument(short_name, long_name);
     auto& argument = help_arguments_[long_name];
     short_to_long_[short_name] = long_name;
@@ -178,7 +184,51 @@ const std::string ArgParser::GetStringValue(const std::string& name) const {
 }
 
 bool ArgParser::Parse(const std::vector<std::string>& args) {
-    if (args.size() == 1) {
+    ArgStream stream(args);
+    stream.EnableResponseFiles();
+    return ParseStream(stream);
+}
+
+bool ArgParser::Parse(int argc, char** argv) {
+    ArgStream stream(argc, argv);
+    stream.EnableResponseFiles();
+    return ParseStream(stream);
+}
+
+// Converts a value and stores it; repeated values are appended only where
+// the syntax allows it (long names and positionals)
+bool ArgParser::ParseIntValue(Argument& argument, std::string_view name,
+                              std::string_view value, bool allow_multi) {
+    bool success = true;
+    int int_value = StrToInt(value, success);
+    if (!success) {
+        std::cerr << "Invalid integer value for argument: " << name
+                  << std::endl;
+        return false;
+    }
+    if (allow_multi && argument.IsMultivalue()) {
+        return AddMultiValue(argument, int_value);
+    } else {
+        argument.SetIntValue(int_value);
+    }
+    return true;
+}
+
+// A full span sink is reported as a parse error
+bool ArgParser::AddMultiValue(Argument& argument, int value) {
+    try {
+        argument.AddIntMulti(value);
+    } catch (const std::runtime_error& error) {
+        std::cerr << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Tokens are std::string_view slices of the source, so nothing is allocated
+// per argument unless a string value has to be stored
+bool ArgParser::ParseStream(ArgStream& args) {
+    if (args.Size() == 1) {
         std::cerr << "No arguments provided.\n";
         for (const auto& pair : string_arguments_) {
             const auto& argument = pair.second;
@@ -191,12 +241,39 @@ bool ArgParser::Parse(const std::vector<std::string>& args) {
         return true;
     }
 
-    size_t positional_idx = 0;
+    if (registry_dirty_) {
+        BuildRegistry();
+    }
+
+    // Positional values go to the first positional int argument
+    Argument* positional = nullptr;
+    for (auto& [name, argument] : int_arguments_) {
+        if (argument.IsPositional()) {
+            positional = &argument;
+            break;
+        }
+    }
+    // Every remaining token may be one of its values
+    if (positional != nullptr && positional->IsMultivalue()) {
+        positional->ReserveValues(args.Size() - 1);
+    }
+
+    // Value of "--name value" / "-n value": the next token unless it is
+    // an option itself
+    auto next_value = [&args](std::string_view& value) {
+        if (!args.HasNext() || args.Peek().substr(0, 1) == "-") {
+            return false;
+        }
+        value = args.Next();
+        return true;
+    };
 
-    for (size_t i = 1; i < args.size(); ++i) {
-        const std::string arg = args[i];
-        size_t pos = arg.find('=');
-        std::cerr << "Processing argument: " << arg << "\n";
+    if (args.HasNext()) {
+        args.Next();  // Program name
+    }
+    while (args.HasNext()) {
+        const std::string_view arg = args.Next();
+        const size_t pos = arg.find('=');
 
         // Help
         if (arg == "--help" || arg == "-h") {
@@ -204,197 +281,168 @@ bool ArgParser::Parse(const std::vector<std::string>& args) {
             return true;
         }
 
-        // Check is positional
-        if (arg[0] == '-') {
-            if (pos == std::string::npos) {
-                // Long Flag
-                if (arg.substr(0, 2) == "--" && arg.size() > 2) {
-                    std::string name = arg.substr(2);
-
-                    if (int_arguments_.count(name)) {
-                        if (i + 1 < args.size() && args[i + 1][0] != '-') {
-                            bool success = true;
-                            int int_value =
-                                StrToInt(args[i + 1].c_str(), success);
-                            if (success) {
-                                auto& argument = int_arguments_[name];
-                                if (argument.IsMultivalue()) {
-                                    argument.AddIntMulti(int_value);
-                                } else {
-                                    argument.SetIntValue(int_value);
-                                }
-                                ++i;
-                            } else {
-                                std::cerr
-                                    << "Invalid integer value for argument: "
-                                    << name << std::endl;
-                                return false;
-                            }
-                        } else {
-                            std::cerr
-                                << "No value provided for integer argument: "
-                                << name << std::endl;
-                            return false;
-                        }
-                    } else if (flag_arguments_.count(name)) {
-                        flag_arguments_[name].SetFlagValue(true);
-                    } else {
-                        std::cerr << "Unknown flag: " << name << std::endl;
+        // Positional
+        if (arg.empty() || arg[0] != '-') {
+            bool success = true;
+            int value = StrToInt(arg, success);
+            if (!success) {
+                std::cerr << "Invalid positional argument value: " << arg
+                          << std::endl;
+                return false;
+            }
+            if (positional == nullptr) {
+                std::cerr << "Unexpected positional argument: " << arg
+                          << std::endl;
+                return false;
+            }
+            if (positional->IsMultivalue()) {
+                if (!AddMultiValue(*positional, value)) {
+                    return false;
+                }
+            } else {
+                positional->SetIntValue(value);
+            }
+            continue;
+        }
+
+        const bool is_long = arg.size() > 2 && arg.substr(0, 2) == "--";
+        if (pos == std::string_view::npos) {
+            if (is_long) {
+                // Long flag or "--name value"; an int wins over a flag
+                std::string_view name = arg.substr(2);
+                const OptionEntry* entry = registry_.Find(name);
+                if (entry != nullptr && entry->Get(OptionKind::kInt)) {
+                    std::string_view value;
+                    if (!next_value(value)) {
+                        std::cerr << "No value provided for integer argument: "
+                                  << name << std::endl;
                         return false;
                     }
-
-                    // Short Flag
-                } else if (arg[0] == '-' && arg.size() > 1) {
-                    char short_name = arg[1];
-                    auto it = short_to_long_.find(short_name);
-                    if (it != short_to_long_.end()) {
-                        const std::string& long_name = it->second;
-                        if (flag_arguments_.count(long_name)) {
-                            flag_arguments_[long_name].SetFlagValue(true);
-                        } else if (int_arguments_.count(long_name)) {
-                            if (i + 1 < args.size() && args[i + 1][0] != '-') {
-                                bool success = true;
-                                int int_value =
-                                    StrToInt(args[i + 1].c_str(), success);
-                                if (success) {
-                                    int_arguments_[long_name].SetIntValue(
-                                        int_value);
-                                    ++i;
-                                } else {
-                                    std::cerr << "Invalid integer value for "
-                                                 "argument: "
-                                              << long_name << std::endl;
-                                    return false;
-                                }
-                            } else {
-                                std::cerr << "No value provided for integer "
-                                             "argument: "
-                                          << long_name << std::endl;
-                                return false;
-                            }
-                        } else if (string_arguments_.count(long_name)) {
-                            if (i + 1 < args.size() && args[i + 1][0] != '-') {
-                                string_arguments_[long_name].SetStringValue(
-                                    args[i + 1]);
-                                ++i;
-                            } else {
-                                std::cerr
-                                    << "No value provided for string argument: "
-                                    << long_name << std::endl;
-                                return false;
-                            }
-                        } else {
-                            std::cerr << "Unknown flag mapped to short name: "
-                                      << short_name << std::endl;
-                            return false;
-                        }
-                    } else {
-                        std::cerr << "Unknown short flag: " << short_name
-                                  << std::endl;
+                    if (!ParseIntValue(*entry->Get(OptionKind::kInt), name,
+                                       value, true)) {
                         return false;
                     }
+                } else if (entry != nullptr && entry->Get(OptionKind::kFlag)) {
+                    entry->Get(OptionKind::kFlag)->SetFlagValue(true);
+                } else {
+                    std::cerr << "Unknown flag: " << name << std::endl;
+                    return false;
+                }
+            } else if (arg.size() > 1) {
+                // Short flag or "-n value"; a flag wins over an int, an int
+                // over a string
+                char short_name = arg[1];
+                const OptionEntry* entry = registry_.FindShort(short_name);
+                if (entry == nullptr) {
+                    std::cerr << "Unknown short flag: " << short_name
+                              << std::endl;
+                    return false;
                 }
-            } else if (pos != std::string::npos) {
-                // If long argument (--key=argument)
-                if (arg.substr(0, 2) == "--" && arg.size() > 2) {
-                    std::string name = arg.substr(2, pos - 2);
-                    std::string value = arg.substr(pos + 1);
-
-                    if (int_arguments_.count(name)) {
-                        auto& argument = int_arguments_[name];
-                        bool success = true;
-                        int int_value = StrToInt(value.c_str(), success);
-
-                        if (!success) {
-                            std::cerr << "Invalid integer value for argument: "
-                                      << name << std::endl;
-                            return false;
-                        }
-                        if (argument.IsMultivalue()) {
-                            argument.AddIntMulti(int_value);
-                        } else {
-                            argument.SetIntValue(int_value);
-                        }
-
-                    } else if (string_arguments_.count(name)) {
-                        string_arguments_[name].SetStringValue(value);
-                    } else {
-                        std::cerr << "Unknown argument: " << name << std::endl;
+                std::string_view long_name = entry->long_name;
+                std::string_view value;
+                if (Argument* flag = entry->Get(OptionKind::kFlag)) {
+                    flag->SetFlagValue(true);
+                } else if (Argument* number = entry->Get(OptionKind::kInt)) {
+                    if (!next_value(value)) {
+                        std::cerr << "No value provided for integer "
+                                     "argument: "
+                                  << long_name << std::endl;
                         return false;
                     }
-                    // if short argument (-k=argument)
-                } else if (arg.size() > 1 && arg[0] == '-' &&
-                           pos != std::string::npos) {
-                    char short_name = arg[1];
-                    std::string value = arg.substr(pos + 1);
-
-                    auto it = short_to_long_.find(short_name);
-                    if (it == short_to_long_.end()) {
-                        std::cerr << "Unknown short argument: " << short_name
-                                  << std::endl;
+                    if (!ParseIntValue(*number, long_name, value, false)) {
                         return false;
                     }
-                    const std::string& long_name = it->second;
-
-                    if (int_arguments_.count(long_name)) {
-                        auto& argument = int_arguments_[long_name];
-                        bool success = true;
-                        int int_value = StrToInt(value.c_str(), success);
-                        if (!success) {
-                            std::cerr << "Invalid integer value for argument: "
-                                      << long_name << std::endl;
-                            return false;
-                        }
-                        argument.SetIntValue(int_value);
-                    } else if (string_arguments_.count(long_name)) {
-                        string_arguments_[long_name].SetStringValue(value);
-                    } else {
-                        std::cerr << "Unknown argument: " << long_name
-                                  << std::endl;
+                } else if (Argument* text = entry->Get(OptionKind::kString)) {
+                    if (!next_value(value)) {
+                        std::cerr << "No value provided for string argument: "
+                                  << long_name << std::endl;
                         return false;
                     }
+                    text->SetStringValue(value);
                 } else {
-                    std::cerr << "Invalid argument: " << arg << "\n";
+                    std::cerr << "Unknown flag mapped to short name: "
+                              << short_name << std::endl;
                     return false;
                 }
-            } else {
-                std::cerr << "Invalid argument: " << arg << "\n";
-                return false;
             }
-        } else if (arg[0] != '-') {
-            bool success = true;
-            int value = StrToInt(arg.c_str(), success);
+            continue;
+        }
 
-            if (!success) {
-                std::cerr << "Invalid positional argument value: " << arg
+        // "--name=value" or "-n=value"
+        std::string_view value = arg.substr(pos + 1);
+        const OptionEntry* entry = nullptr;
+        std::string_view name;
+        if (is_long) {
+            name = arg.substr(2, pos - 2);
+            entry = registry_.Find(name);
+        } else if (arg.size() > 1) {
+            char short_name = arg[1];
+            entry = registry_.FindShort(short_name);
+            if (entry == nullptr) {
+                std::cerr << "Unknown short argument: " << short_name
                           << std::endl;
                 return false;
             }
+            name = entry->long_name;
+        } else {
+            std::cerr << "Invalid argument: " << arg << "\n";
+            return false;
+        }
 
-            bool handle = false;
-            for (auto& [name, argument] : int_arguments_) {
-                if (argument.IsPositional()) {
-                    if (argument.IsMultivalue()) {
-                        argument.AddIntMulti(value);
-                    } else {
-                        argument.SetIntValue(value);
-                    }
-                    handle = true;
-                    break;
-                }
-            }
-            if (!handle) {
-                std::cerr << "Unexpected positional argument: " << arg
-                          << std::endl;
+        // An int wins over a string
+        if (entry != nullptr && entry->Get(OptionKind::kInt)) {
+            if (!ParseIntValue(*entry->Get(OptionKind::kInt), name, value,
+                               is_long)) {
                 return false;
             }
-            continue;
+        } else if (entry != nullptr && entry->Get(OptionKind::kString)) {
+            entry->Get(OptionKind::kString)->SetStringValue(value);
+        } else {
+            std::cerr << "Unknown argument: " << name << std::endl;
+            return false;
+        }
+    }
+
+    if (!CheckRequired()) {
+        return false;
+    }
+
+    for (auto& [name, flag] : flag_arguments_) {
+        if (!flag.GetFlagValue()) {
+            flag.SetFlagValue(true);
         }
     }
 
+    return true;
+}
+
+// A long name registered under several kinds keeps all of them; Parse picks
+// one by the form of the token, in the same order as before the registry
+void ArgParser::BuildRegistry() {
+    registry_.Clear();
+    for (auto& [name, argument] : int_arguments_) {
+        registry_.Add(name, OptionKind::kInt, &argument);
+    }
+    for (auto& [name, argument] : flag_arguments_) {
+        registry_.Add(name, OptionKind::kFlag, &argument);
+    }
+    for (auto& [name, argument] : string_arguments_) {
+        registry_.Add(name, OptionKind::kString, &argument);
+    }
+    for (auto& [name, argument] : help_arguments_) {
+        registry_.Add(name, OptionKind::kHelp, &argument);
+    }
+    for (const auto& [short_name, long_name] : short_to_long_) {
+        registry_.AddShort(short_name, long_name);
+    }
+    registry_.Freeze();
+    registry_dirty_ = false;
+}
+
+bool ArgParser::CheckRequired() const {
     for (const auto& [name, argument] : int_arguments_) {
         if (argument.GetRequired() && argument.IsMultivalue() &&
-            argument.GetIntValues().empty()) {
+            argument.GetIntCount() == 0) {
             std::cerr << "Required multi-value integer argument " << name
                       << " not provided or empty.\n";
             return false;
@@ -402,7 +450,7 @@ bool ArgParser::Parse(const std::vector<std::string>& args) {
         if (argument.IsMultivalue() && !argument.IsValidMultiValue()) {
             std::cerr << "Argument " << name << " requires at least "
                       << argument.GetMinMultiValue() << " values, but "
-                      << argument.GetIntValues().size() << " were provided.\n";
+                      << argument.GetIntCount() << " were provided.\n";
             return false;
         }
     }
@@ -414,13 +462,6 @@ bool ArgParser::Parse(const std::vector<std::string>& args) {
             return false;
         }
     }
-
-    for (auto& [name, flag] : flag_arguments_) {
-        if (!flag.GetFlagValue()) {
-            flag.SetFlagValue(true);
-        }
-    }
-
     return true;
 }
 
@@ -1,18 +1,36 @@
 #pragma once
+#include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "../Argument/Argument.h"
+#include "ArgStream.h"
+#include "OptionRegistry.h"
 
 namespace ArgumentParser {
 
+// Hash for std::string keys that also accepts std::string_view, so lookups
+// by a token slice do not build a temporary std::string
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+using ArgumentMap =
+    std::unordered_map<std::string, Argument, StringHash, std::equal_to<>>;
+
 class ArgParser {
    public:
     ArgParser(const std::string& name) : name_(name) {}
 
     // Parsing arguments
+    // "@path" arguments are expanded from response files, see ArgStream
     bool Parse(const std::vector<std::string>& args);
+    bool Parse(int argc, char** argv);
 
     // String methods
     Argument& AddStringArgument(const std::string& long_name);
@@ -47,12 +65,23 @@ class ArgParser {
 
    private:
     std::string name_;
-    std::unordered_map<std::string, Argument> string_arguments_;
-    std::unordered_map<std::string, Argument> int_arguments_;
-    std::unordered_map<std::string, Argument> flag_arguments_;
-    std::unordered_map<std::string, Argument> help_arguments_;
+    ArgumentMap string_arguments_;
+    ArgumentMap int_arguments_;
+    ArgumentMap flag_arguments_;
+    ArgumentMap help_arguments_;
     std::unordered_map<char, std::string> short_to_long_;
     std::vector<Argument*> positional_arguments_;
+
+    // Lookup table for Parse, rebuilt on the first Parse after any Add*
+    OptionRegistry registry_;
+    bool registry_dirty_ = true;
+
+    void BuildRegistry();
+    bool ParseStream(ArgStream& args);
+    bool AddMultiValue(Argument& argument, int value);
+    bool ParseIntValue(Argument& argument, std::string_view name,
+                       std::string_view value, bool allow_multi);
+    bool CheckRequired() const;
 };
 
 }  // namespace ArgumentParser
\ No newline at end of file
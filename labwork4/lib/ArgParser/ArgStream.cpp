@@ -0,0 +1,145 @@
+#include "ArgStream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ArgumentParser {
+
+namespace {
+
+// Consumed part of a response file is dropped in chunks of this size
+constexpr size_t kReleaseChunk = size_t{1} << 20;
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' ||
+           c == '\v';
+}
+
+}  // namespace
+
+ArgStream::ArgStream(int argc, char** argv)
+    : argv_(argv), size_(argc > 0 ? static_cast<size_t>(argc) : 0) {}
+
+ArgStream::ArgStream(const std::vector<std::string>& args)
+    : strings_(args.data()), size_(args.size()) {}
+
+ArgStream::~ArgStream() {
+    for (const ResponseFile& file : mapped_) {
+        munmap(const_cast<char*>(file.data), file.size);
+    }
+}
+
+bool ArgStream::HasNext() { return has_pending_ || Fill(); }
+
+std::string_view ArgStream::Peek() {
+    if (!has_pending_) {
+        Fill();
+    }
+    return pending_;
+}
+
+std::string_view ArgStream::Next() {
+    std::string_view token = Peek();
+    has_pending_ = false;
+    return token;
+}
+
+// Loads the next token into pending_, descending into response files
+bool ArgStream::Fill() {
+    while (true) {
+        std::string_view token;
+        bool expandable = true;
+        if (!files_.empty()) {
+            if (!NextWord(files_.back(), token)) {
+                FinishResponseFile();
+                continue;
+            }
+        } else {
+            if (position_ >= size_) {
+                return false;
+            }
+            token = argv_ != nullptr ? std::string_view(argv_[position_])
+                                     : std::string_view(strings_[position_]);
+            expandable = position_ > 0;  // Never the program name
+            ++position_;
+        }
+
+        if (response_files_ && expandable && token.size() > 1 &&
+            token[0] == '@' && files_.size() < kMaxDepth &&
+            OpenResponseFile(token.substr(1))) {
+            continue;
+        }
+        pending_ = token;
+        has_pending_ = true;
+        return true;
+    }
+}
+
+bool ArgStream::OpenResponseFile(std::string_view path) {
+    std::string filename(path);
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    const char* data = nullptr;
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+        mapped_.push_back({data, size, 0, 0});
+    }
+    close(fd);
+    files_.push_back({data, size, 0, 0});
+    return true;
+}
+
+void ArgStream::FinishResponseFile() {
+    const ResponseFile& file = files_.back();
+    if (file.size > file.released) {
+        madvise(const_cast<char*>(file.data) + file.released,
+                file.size - file.released, MADV_DONTNEED);
+    }
+    files_.pop_back();
+}
+
+bool ArgStream::NextWord(ResponseFile& file, std::string_view& word) {
+    size_t offset = file.offset;
+    while (offset < file.size && IsSpace(file.data[offset])) {
+        ++offset;
+    }
+    if (offset == file.size) {
+        file.offset = offset;
+        return false;
+    }
+    size_t start = offset;
+    while (offset < file.size && !IsSpace(file.data[offset])) {
+        ++offset;
+    }
+    word = std::string_view(file.data + start, offset - start);
+    file.offset = offset;
+
+    // Pages behind the previous token are dropped; the mapping is read-only
+    // and private, so touching them again just reads the file back
+    if (start - file.released >= 2 * kReleaseChunk) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t release_end = (start - kReleaseChunk) / page * page;
+        madvise(const_cast<char*>(file.data) + file.released,
+                release_end - file.released, MADV_DONTNEED);
+        file.released = release_end;
+    }
+    return true;
+}
+
+}  // namespace ArgumentParser
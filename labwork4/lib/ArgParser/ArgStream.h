@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Command-line tokens viewed in place: argv strings or a vector of
+// std::string. Nothing is copied, tokens stay valid while the source lives.
+//
+// With response files enabled, a token "@path" is replaced by the
+// whitespace-separated words of that file (nested up to kMaxDepth). The
+// file is memory-mapped and split lazily, one token at a time, and pages
+// already read are released as the stream moves on, so memory stays
+// bounded whatever the file size. Files stay mapped until the stream is
+// destroyed, so their tokens live as long as argv ones (a released page
+// is read back from the file if touched). A file that cannot be read is
+// passed through as the literal "@path" token
+class ArgStream {
+   public:
+    static constexpr size_t kMaxDepth = 8;
+
+    ArgStream(int argc, char** argv);
+    explicit ArgStream(const std::vector<std::string>& args);
+    ~ArgStream();
+    ArgStream(const ArgStream&) = delete;
+    ArgStream& operator=(const ArgStream&) = delete;
+
+    void EnableResponseFiles() { response_files_ = true; }
+
+    // Number of command-line tokens, including the program name; words
+    // of response files are not counted
+    size_t Size() const { return size_; }
+    bool HasNext();
+    std::string_view Peek();
+    std::string_view Next();
+
+   private:
+    struct ResponseFile {
+        const char* data;
+        size_t size;
+        size_t offset;    // Next unread byte
+        size_t released;  // Bytes before this are given back to the kernel
+    };
+
+    bool Fill();
+    bool OpenResponseFile(std::string_view path);
+    void FinishResponseFile();
+    bool NextWord(ResponseFile& file, std::string_view& word);
+
+    char** argv_ = nullptr;
+    const std::string* strings_ = nullptr;
+    size_t size_ = 0;
+    size_t position_ = 0;
+
+    bool response_files_ = false;
+    std::vector<ResponseFile> files_;   // Being read, innermost last
+    std::vector<ResponseFile> mapped_;  // All opened, unmapped at the end
+    std::string_view pending_;
+    bool has_pending_ = false;
+};
+
+}  // namespace ArgumentParser
@@ -0,0 +1,116 @@
+#include "OptionRegistry.h"
+
+#include <algorithm>
+
+namespace ArgumentParser {
+
+namespace {
+
+constexpr uint64_t kSeedAttempts = 64;
+
+}  // namespace
+
+void OptionRegistry::Clear() {
+    entries_.clear();
+    short_names_.clear();
+    slots_.clear();
+    short_table_.fill(nullptr);
+}
+
+void OptionRegistry::Add(std::string_view long_name, OptionKind kind,
+                         Argument* argument) {
+    OptionEntry* entry = FindSlow(long_name);
+    if (entry == nullptr) {
+        entry = &entries_.emplace_back();
+        entry->long_name = long_name;
+    }
+    Argument*& slot = entry->arguments[static_cast<size_t>(kind)];
+    if (slot == nullptr) {
+        slot = argument;
+    }
+}
+
+void OptionRegistry::AddShort(char short_name, std::string_view long_name) {
+    short_names_.emplace_back(short_name, long_name);
+}
+
+// FNV-1a with the seed folded into the offset basis
+uint64_t OptionRegistry::Hash(std::string_view name, uint64_t seed) {
+    uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ (hash >> 29);
+}
+
+bool OptionRegistry::TryBuild(size_t table_size, uint64_t seed,
+                              bool probing) {
+    slots_.assign(table_size, -1);
+    mask_ = table_size - 1;
+    seed_ = seed;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        uint64_t slot = Hash(entries_[i].long_name, seed) & mask_;
+        while (slots_[slot] != -1) {
+            if (!probing) {
+                return false;
+            }
+            slot = (slot + 1) & mask_;
+        }
+        slots_[slot] = static_cast<int32_t>(i);
+    }
+    return true;
+}
+
+void OptionRegistry::Freeze() {
+    // Smallest power of two at most half full, and the largest size the
+    // search for a collision-free seed may try: 8n slots, at least 8
+    size_t min_size = 8;
+    while (min_size < entries_.size() * 2) {
+        min_size *= 2;
+    }
+    size_t max_size = std::max<size_t>(min_size, entries_.size() * 8);
+    bool built = false;
+    for (size_t table_size = min_size; table_size <= max_size && !built;
+         table_size *= 2) {
+        for (uint64_t seed = 0; seed < kSeedAttempts && !built; ++seed) {
+            built = TryBuild(table_size, seed, false);
+        }
+    }
+    if (!built) {
+        TryBuild(min_size, 0, true);
+    }
+
+    short_table_.fill(nullptr);
+    for (const auto& [short_name, long_name] : short_names_) {
+        short_table_[static_cast<unsigned char>(short_name)] = Find(long_name);
+    }
+}
+
+const OptionEntry* OptionRegistry::Find(std::string_view long_name) const {
+    if (slots_.empty()) {
+        return nullptr;
+    }
+    // The table is at most half full, so an empty slot ends every probe
+    for (uint64_t slot = Hash(long_name, seed_) & mask_;;
+         slot = (slot + 1) & mask_) {
+        int32_t index = slots_[slot];
+        if (index < 0) {
+            return nullptr;
+        }
+        if (entries_[index].long_name == long_name) {
+            return &entries_[index];
+        }
+    }
+}
+
+OptionEntry* OptionRegistry::FindSlow(std::string_view long_name) {
+    for (auto& entry : entries_) {
+        if (entry.long_name == long_name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace ArgumentParser
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../Argument/Argument.h"
+
+namespace ArgumentParser {
+
+enum class OptionKind : uint8_t { kInt, kString, kFlag, kHelp };
+
+// One long name with the argument of each kind registered under it; the
+// parser decides which kind a token means, as the form of the token allows
+struct OptionEntry {
+    std::string_view long_name;  // Points into the owning map's key
+    std::array<Argument*, 4> arguments{};  // Indexed by OptionKind
+
+    Argument* Get(OptionKind kind) const {
+        return arguments[static_cast<size_t>(kind)];
+    }
+};
+
+// Read-only lookup table over every option of a parser. Built once after
+// setup: long names go into an open-addressing table at most half full,
+// short names into a 256-entry array. The seed is searched, and the table
+// doubled while it stays within 8n slots, until no two names share a slot;
+// then a lookup is a single probe plus one name comparison. Failing that,
+// the smallest table is built with linear probing, so it never exceeds
+// max(8, 8n) slots
+class OptionRegistry {
+   public:
+    void Clear();
+    // The first registration of a long name for a kind wins
+    void Add(std::string_view long_name, OptionKind kind, Argument* argument);
+    void AddShort(char short_name, std::string_view long_name);
+    void Freeze();
+
+    const OptionEntry* Find(std::string_view long_name) const;
+    const OptionEntry* FindShort(char short_name) const {
+        return short_table_[static_cast<unsigned char>(short_name)];
+    }
+
+   private:
+    std::vector<OptionEntry> entries_;
+    std::vector<std::pair<char, std::string_view>> short_names_;
+    std::vector<int32_t> slots_;  // Index into entries_ or -1
+    uint64_t seed_ = 0;
+    uint64_t mask_ = 0;
+    std::array<const OptionEntry*, 256> short_table_{};
+
+    static uint64_t Hash(std::string_view name, uint64_t seed);
+    // Without probing fails on the first shared slot
+    bool TryBuild(size_t table_size, uint64_t seed, bool probing);
+    OptionEntry* FindSlow(std::string_view long_name);
+};
+
+}  // namespace ArgumentParser
@@ -1,6 +1,7 @@
 #include "Argument.h"
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
 #include "../Functions/Functions.h"
@@ -10,8 +11,8 @@ Argument& Argument::StoreValue(std::string& value) {
     return *this;
 }
 
-Argument& Argument::StoreValues(std::vector<int>& external_values) {
-    stored_values_ = &external_values;
+Argument& Argument::StoreValues(std::span<int> external_buffer) {
+    sink_ = IntSink(external_buffer);
     return *this;
 }
 
@@ -35,22 +36,38 @@ Argument& Argument::AddIntMulti(int value) {
     if (!is_multivalue_) {
         throw std::runtime_error("Argument is not multivalue");
     }
-    int_values_.push_back(value);
-    if (stored_values_) {
-        stored_values_->push_back(value);
+    if (sink_.IsSet()) {
+        if (!sink_.Push(value)) {
+            throw std::runtime_error("Too many values for argument: " +
+                                     long_name_);
+        }
+    } else {
+        int_values_.push_back(value);
     }
+    if (int_count_ == 0) {
+        int_value_ = value;  // First value, for GetIntValue
+    }
+    ++int_count_;
     return *this;
 }
 
+void Argument::ReserveValues(size_t count) {
+    if (sink_.IsSet()) {
+        sink_.Reserve(count);
+    } else {
+        int_values_.reserve(int_values_.size() + count);
+    }
+}
+
 Argument& Argument::Positional() {
     is_positional_ = true;
     return *this;
 }
 
-Argument& Argument::SetStringValue(const std::string& value) {
-    string_value_ = value;
+Argument& Argument::SetStringValue(std::string_view value) {
+    string_value_.assign(value);
     if (external_value_) {
-        *external_value_ = value;
+        external_value_->assign(value);
     }
     return *this;
 }
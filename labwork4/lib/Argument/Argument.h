@@ -1,9 +1,14 @@
 #pragma once
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "IntSink.h"
+
 class Argument {
    public:
     Argument(char short_name = '\0', const std::string& long_name = "")
@@ -21,19 +26,41 @@ class Argument {
     };
     bool GetRequired() const { return is_required_; }
     int GetIntValueA() const {
-        return (int_value_ == 0 && default_int_.has_value()) ? *default_int_
-                                                             : int_value_;
+        return (int_count_ == 0 && int_value_ == 0 && default_int_.has_value())
+                   ? *default_int_
+                   : int_value_;
     };
+    // Copy of the parsed values, whatever sink they went to
     std::vector<int> GetIntValues() const {
-        return is_multivalue_ ? int_values_ : std::vector<int>{int_value_};
+        if (!is_multivalue_) {
+            return {int_value_};
+        }
+        return sink_.IsSet() ? sink_.Copy(int_count_) : int_values_;
+    }
+    // The same without copying; throws if the values went to a
+    // non-contiguous sink such as std::deque
+    std::span<const int> GetIntView() const {
+        if (!is_multivalue_) {
+            return {&int_value_, 1};
+        }
+        if (!sink_.IsSet()) {
+            return int_values_;
+        }
+        if (!sink_.IsContiguous()) {
+            throw std::logic_error("Values of " + long_name_ +
+                                   " are in a non-contiguous sink");
+        }
+        return sink_.Values(int_count_);
     }
-    std::vector<int>* GetStoredValues() { return stored_values_; }
+    // The vector given to StoreValues, nullptr for other sinks
+    std::vector<int>* GetStoredValues() { return sink_.GetVector(); }
+    size_t GetIntCount() const { return is_multivalue_ ? int_count_ : 1; }
     size_t GetMinMultiValue() const { return min_multivalue_count_; }
     bool GetFlagValue() const { return flag_value_; }
     const std::string& GetDescription() const { return description_; }
 
     // Setters
-    Argument& SetStringValue(const std::string& value);
+    Argument& SetStringValue(std::string_view value);
     Argument& SetRequired(bool required);
     Argument& SetIntValue(int value);
     Argument& SetIsInt(bool is_int);
@@ -49,14 +76,20 @@ class Argument {
 
     // StoreValue
     Argument& StoreValue(std::string& external_value);
-    Argument& StoreValues(std::vector<int>& external_values);
+    template <typename Container>
+        requires requires(Container& c, int v) { c.push_back(v); }
+    Argument& StoreValues(Container& external_values) {
+        sink_ = IntSink(external_values);
+        return *this;
+    }
+    Argument& StoreValues(std::span<int> external_buffer);
     Argument& StoreValue(bool& external_flag_value);
 
     // Checkers
     bool IsIntArgument() const { return is_int_; }
     bool IsMultivalue() const { return is_multivalue_; }
     bool IsValidMultiValue() const {
-        return int_values_.size() >= min_multivalue_count_;
+        return int_count_ >= min_multivalue_count_;
     }
     bool IsFlag() const { return is_flag_; }
     bool IsPositional() const { return is_positional_; }
@@ -65,7 +98,10 @@ class Argument {
     // MultiValue
     Argument& MultiValue();
     Argument& MultiValue(size_t min_count);
+    // Throws if the argument is not multi-value or a span sink is full
     Argument& AddIntMulti(int value);
+    // Capacity hint before a run of AddIntMulti calls
+    void ReserveValues(size_t count);
 
     // Positional
     Argument& Positional();
@@ -92,9 +128,10 @@ class Argument {
 
     std::string description_;
     std::string string_value_;
-    std::vector<int> int_values_;
+    std::vector<int> int_values_;  // Only used without a sink
+    size_t int_count_ = 0;
+    IntSink sink_;
     std::string* external_value_ = nullptr;
-    std::vector<int>* stored_values_ = nullptr;
     bool* external_flag_value_ = nullptr;
     int int_value_ = 0;
 };
\ No newline at end of file
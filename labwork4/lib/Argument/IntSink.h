@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Caller-owned destination for multi-value integers. Either any container
+// with push_back (values are appended, reserve is used when available) or
+// a span with fixed capacity. Parsed values are written here directly and
+// are not kept anywhere else
+class IntSink {
+   public:
+    IntSink() = default;
+
+    template <typename Container>
+        requires requires(Container& c, int v) { c.push_back(v); }
+    explicit IntSink(Container& container)
+        : target_(&container),
+          push_(&PushBack<Container>),
+          reserve_(&ReserveMore<Container>),
+          view_(&Tail<Container>),
+          copy_(&CopyTail<Container>),
+          contiguous_(std::ranges::contiguous_range<Container>) {
+        static_assert(std::is_same_v<typename Container::value_type, int>,
+                      "Sink must hold int values");
+        if constexpr (std::is_same_v<Container, std::vector<int>>) {
+            vector_ = &container;
+        }
+    }
+
+    explicit IntSink(std::span<int> buffer)
+        : buffer_(buffer.data()), capacity_(buffer.size()) {}
+
+    bool IsSet() const { return target_ != nullptr || buffer_ != nullptr; }
+    // Whether Values can return a view
+    bool IsContiguous() const {
+        return buffer_ != nullptr || contiguous_;
+    }
+    // The sink itself when it is a std::vector<int>
+    std::vector<int>* GetVector() const { return vector_; }
+
+    // False when a span sink is full
+    bool Push(int value) {
+        if (buffer_ != nullptr) {
+            if (used_ == capacity_) {
+                return false;
+            }
+            buffer_[used_++] = value;
+            return true;
+        }
+        push_(target_, value);
+        return true;
+    }
+
+    // Hint for the number of values still to come
+    void Reserve(size_t count) {
+        if (reserve_ != nullptr) {
+            reserve_(target_, count);
+        }
+    }
+
+    // The last `count` values, if the sink stores them contiguously;
+    // empty for list-like containers
+    std::span<const int> Values(size_t count) const {
+        if (buffer_ != nullptr) {
+            return {buffer_, used_};
+        }
+        return view_ != nullptr ? view_(target_, count)
+                                : std::span<const int>();
+    }
+
+    // The last `count` values copied out, for any kind of sink
+    std::vector<int> Copy(size_t count) const {
+        if (buffer_ != nullptr) {
+            return std::vector<int>(buffer_, buffer_ + used_);
+        }
+        return copy_ != nullptr ? copy_(target_, count) : std::vector<int>();
+    }
+
+   private:
+    template <typename Container>
+    static void PushBack(void* target, int value) {
+        static_cast<Container*>(target)->push_back(value);
+    }
+
+    template <typename Container>
+    static void ReserveMore(void* target, size_t count) {
+        auto& container = *static_cast<Container*>(target);
+        if constexpr (requires { container.reserve(count); }) {
+            container.reserve(container.size() + count);
+        }
+    }
+
+    template <typename Container>
+    static std::span<const int> Tail(const void* target, size_t count) {
+        const auto& container = *static_cast<const Container*>(target);
+        if constexpr (std::ranges::contiguous_range<Container>) {
+            return {std::data(container) + std::size(container) - count,
+                    count};
+        } else {
+            return {};
+        }
+    }
+
+    template <typename Container>
+    static std::vector<int> CopyTail(const void* target, size_t count) {
+        const auto& container = *static_cast<const Container*>(target);
+        return std::vector<int>(
+            std::prev(std::end(container), static_cast<ptrdiff_t>(count)),
+            std::end(container));
+    }
+
+    void* target_ = nullptr;
+    void (*push_)(void*, int) = nullptr;
+    void (*reserve_)(void*, size_t) = nullptr;
+    std::span<const int> (*view_)(const void*, size_t) = nullptr;
+    std::vector<int> (*copy_)(const void*, size_t) = nullptr;
+    bool contiguous_ = false;
+    std::vector<int>* vector_ = nullptr;
+
+    int* buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+};
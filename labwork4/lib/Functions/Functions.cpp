@@ -5,24 +5,28 @@
 #include <iostream>
 
 int StrToInt(const char* str, bool& success) {
+    return StrToInt(std::string_view(str), success);
+}
+
+int StrToInt(std::string_view str, bool& success) {
     int result = 0;
     int sign = 1;    // Flag for negative numbers
     success = true;  // Convertation success flag
-    int i = 0;
+    size_t i = 0;
 
-    while (str[i] == ' ') {
+    while (i < str.size() && str[i] == ' ') {
         i++;
     }
 
     // Checking + or -
-    if (str[i] == '-') {
+    if (i < str.size() && str[i] == '-') {
         sign = -1;
         i++;
-    } else if (str[i] == '+') {
+    } else if (i < str.size() && str[i] == '+') {
         i++;
     }
 
-    for (; str[i] != '\0'; i++) {
+    for (; i < str.size(); i++) {
         if (str[i] >= '0' && str[i] <= '9') {
             int digit = str[i] - '0';
 
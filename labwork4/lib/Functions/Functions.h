@@ -1,11 +1,13 @@
 #pragma once
 #include <sstream>
+#include <string_view>
 
 int StrToInt(const char *str, bool &success);
+int StrToInt(std::string_view str, bool &success);
 
 template <typename Arg>
 std::string ToStringMy(const Arg &value) {
     std::ostringstream os;
     os << value;
     return os.str();
-}
\ No newline at end of file
+}
@@ -0,0 +1,332 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../ArgParser/ArgStream.h"
+
+namespace ArgumentParser {
+
+// String literal usable as a template argument: IntOption<"port">
+template <size_t N>
+struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&str)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            data[i] = str[i];
+        }
+    }
+    constexpr std::string_view View() const { return {data, N - 1}; }
+};
+
+enum class StaticKind : uint8_t { kInt, kString, kFlag, kPositional };
+
+// Option descriptors. Each one names the option and fixes its value type,
+// so the whole schema is a type and its tables are built by the compiler
+
+template <FixedString Name, char ShortName = '\0', int DefaultValue = 0>
+struct IntOption {
+    using ValueType = int;
+    static constexpr std::string_view kName = Name.View();
+    static constexpr char kShortName = ShortName;
+    static constexpr StaticKind kKind = StaticKind::kInt;
+    static constexpr size_t kMinCount = 0;
+    static constexpr ValueType Default() { return DefaultValue; }
+};
+
+// Value is a view into the argument it came from
+template <FixedString Name, char ShortName = '\0'>
+struct StringOption {
+    using ValueType = std::string_view;
+    static constexpr std::string_view kName = Name.View();
+    static constexpr char kShortName = ShortName;
+    static constexpr StaticKind kKind = StaticKind::kString;
+    static constexpr size_t kMinCount = 0;
+    static constexpr ValueType Default() { return {}; }
+};
+
+template <FixedString Name, char ShortName = '\0'>
+struct FlagOption {
+    using ValueType = bool;
+    static constexpr std::string_view kName = Name.View();
+    static constexpr char kShortName = ShortName;
+    static constexpr StaticKind kKind = StaticKind::kFlag;
+    static constexpr size_t kMinCount = 0;
+    static constexpr ValueType Default() { return false; }
+};
+
+// Collects every positional integer; at most one per schema
+template <FixedString Name, size_t MinCount = 0>
+struct PositionalInts {
+    using ValueType = std::vector<int>;
+    static constexpr std::string_view kName = Name.View();
+    static constexpr char kShortName = '\0';
+    static constexpr StaticKind kKind = StaticKind::kPositional;
+    static constexpr size_t kMinCount = MinCount;
+    static ValueType Default() { return {}; }
+};
+
+// Parser generated from a list of descriptors. Name lookup goes through
+// a compile-time table from the first character to a bitmask of candidate
+// options, short names through a 256-entry table; storing a value is a
+// switch over the option index. Get<"name">() is resolved at compile time
+// and a misspelled name does not compile
+template <typename... Options>
+class StaticArgParser {
+    static constexpr size_t kCount = sizeof...(Options);
+    static_assert(kCount <= 64, "At most 64 options per schema");
+
+    static constexpr std::array<std::string_view, kCount> kNames = {
+        Options::kName...};
+    static constexpr std::array<StaticKind, kCount> kKinds = {
+        Options::kKind...};
+    static constexpr std::array<size_t, kCount> kMinCounts = {
+        Options::kMinCount...};
+
+    static constexpr std::array<uint64_t, 256> kByFirstChar = [] {
+        std::array<uint64_t, 256> table{};
+        for (size_t i = 0; i < kCount; ++i) {
+            if (!kNames[i].empty()) {
+                table[static_cast<unsigned char>(kNames[i][0])] |=
+                    uint64_t{1} << i;
+            }
+        }
+        return table;
+    }();
+
+    static constexpr std::array<int8_t, 256> kByShortName = [] {
+        std::array<int8_t, 256> table{};
+        table.fill(-1);
+        constexpr std::array<char, kCount> short_names = {
+            Options::kShortName...};
+        for (size_t i = 0; i < kCount; ++i) {
+            if (short_names[i] != '\0') {
+                table[static_cast<unsigned char>(short_names[i])] =
+                    static_cast<int8_t>(i);
+            }
+        }
+        return table;
+    }();
+
+    static constexpr int kPositional = [] {
+        int index = -1;
+        for (size_t i = 0; i < kCount; ++i) {
+            if (kKinds[i] == StaticKind::kPositional) {
+                index = static_cast<int>(i);
+            }
+        }
+        return index;
+    }();
+
+    template <FixedString Name>
+    static constexpr size_t IndexOf() {
+        size_t index = kCount;
+        for (size_t i = 0; i < kCount; ++i) {
+            if (kNames[i] == Name.View()) {
+                index = i;
+            }
+        }
+        return index;
+    }
+
+   public:
+    class Result {
+       public:
+        template <FixedString Name>
+        const auto& Get() const {
+            static_assert(IndexOf<Name>() < kCount, "Unknown option name");
+            return std::get<IndexOf<Name>()>(values_);
+        }
+        // Whether the option appeared on the command line
+        template <FixedString Name>
+        bool Has() const {
+            static_assert(IndexOf<Name>() < kCount, "Unknown option name");
+            return (present_ >> IndexOf<Name>()) & 1;
+        }
+
+       private:
+        friend class StaticArgParser;
+        std::tuple<typename Options::ValueType...> values_{
+            Options::Default()...};
+        uint64_t present_ = 0;
+    };
+
+    static bool Parse(int argc, char** argv, Result& result) {
+        ArgStream stream(argc, argv);
+        return Parse(stream, result);
+    }
+
+    static bool Parse(const std::vector<std::string>& args, Result& result) {
+        ArgStream stream(args);
+        return Parse(stream, result);
+    }
+
+    static bool Parse(ArgStream& args, Result& result) {
+        if (args.HasNext()) {
+            args.Next();  // Program name
+        }
+        while (args.HasNext()) {
+            std::string_view arg = args.Next();
+
+            if (arg.empty() || arg[0] != '-') {
+                if constexpr (kPositional >= 0) {
+                    if (!Store(result, kPositional, arg)) {
+                        return false;
+                    }
+                    continue;
+                }
+                std::cerr << "Unexpected positional argument: " << arg
+                          << std::endl;
+                return false;
+            }
+
+            // "--name", "--name=value", "-n", "-n=value"
+            int index;
+            std::string_view rest;
+            size_t pos = arg.find('=');
+            bool has_value = pos != std::string_view::npos;
+            if (arg.size() > 2 && arg[1] == '-') {
+                index = FindLong(arg.substr(2, has_value ? pos - 2 : pos));
+            } else if (arg.size() == 2 || (arg.size() > 2 && pos == 2)) {
+                index = kByShortName[static_cast<unsigned char>(arg[1])];
+            } else {
+                index = -1;
+            }
+            if (index < 0) {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return false;
+            }
+            if (has_value) {
+                rest = arg.substr(pos + 1);
+            }
+
+            if (kKinds[index] == StaticKind::kFlag) {
+                result.present_ |= uint64_t{1} << index;
+                SetFlag(result, index);
+                continue;
+            }
+            if (!has_value) {
+                // Value in the next token
+                if (!args.HasNext() || args.Peek().substr(0, 1) == "-") {
+                    std::cerr << "No value provided for argument: "
+                              << kNames[index] << std::endl;
+                    return false;
+                }
+                rest = args.Next();
+            }
+            if (!Store(result, index, rest)) {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < kCount; ++i) {
+            if (kMinCounts[i] > 0 && PositionalCount(result) < kMinCounts[i]) {
+                std::cerr << "Argument " << kNames[i] << " requires at least "
+                          << kMinCounts[i] << " values" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+   private:
+    static constexpr int FindLong(std::string_view name) {
+        if (name.empty()) {
+            return -1;
+        }
+        uint64_t candidates =
+            kByFirstChar[static_cast<unsigned char>(name[0])];
+        while (candidates != 0) {
+            int index = std::countr_zero(candidates);
+            if (kNames[index] == name) {
+                return index;
+            }
+            candidates &= candidates - 1;
+        }
+        return -1;
+    }
+
+    static bool ParseInt(std::string_view value, std::string_view name,
+                         int& out) {
+        const char* end = value.data() + value.size();
+        auto [ptr, error] = std::from_chars(value.data(), end, out);
+        if (error != std::errc() || ptr != end || value.empty()) {
+            std::cerr << "Invalid integer value for argument: " << name
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    template <size_t I>
+    static bool StoreAt(Result& result, std::string_view value) {
+        auto& slot = std::get<I>(result.values_);
+        result.present_ |= uint64_t{1} << I;
+        if constexpr (kKinds[I] == StaticKind::kInt) {
+            return ParseInt(value, kNames[I], slot);
+        } else if constexpr (kKinds[I] == StaticKind::kString) {
+            slot = value;
+            return true;
+        } else if constexpr (kKinds[I] == StaticKind::kPositional) {
+            int number;
+            if (!ParseInt(value, kNames[I], number)) {
+                return false;
+            }
+            slot.push_back(number);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    static bool Store(Result& result, int index, std::string_view value) {
+        return StoreByIndex(result, index, value,
+                            std::make_index_sequence<kCount>{});
+    }
+
+    template <size_t... I>
+    static bool StoreByIndex(Result& result, int index, std::string_view value,
+                             std::index_sequence<I...>) {
+        bool stored = false;
+        ((index == static_cast<int>(I)
+              ? (stored = StoreAt<I>(result, value), true)
+              : false) ||
+         ...);
+        return stored;
+    }
+
+    static void SetFlag(Result& result, int index) {
+        SetFlagByIndex(result, index, std::make_index_sequence<kCount>{});
+    }
+
+    template <size_t... I>
+    static void SetFlagByIndex(Result& result, int index,
+                               std::index_sequence<I...>) {
+        (
+            [&] {
+                if constexpr (kKinds[I] == StaticKind::kFlag) {
+                    if (index == static_cast<int>(I)) {
+                        std::get<I>(result.values_) = true;
+                    }
+                }
+            }(),
+            ...);
+    }
+
+    static size_t PositionalCount(const Result& result) {
+        if constexpr (kPositional >= 0) {
+            return std::get<kPositional>(result.values_).size();
+        }
+        return 0;
+    }
+};
+
+}  // namespace ArgumentParser
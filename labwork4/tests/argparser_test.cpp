@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <deque>
 #include <fstream>
 #include <sstream>
 
@@ -212,4 +213,142 @@ TEST(ArgParserTestSuite, HelpStringTest) {
     //     "\n"
     //     "-h, --help Display this help and exit\n"
     // );
-}
\ No newline at end of file
+}
+
+TEST(ArgParserTestSuite, ArgvTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddStringArgument('i', "input", "File path for input file");
+    parser.AddFlag('f', "flag", "Flag");
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().StoreValues(
+        values);
+
+    char app[] = "app";
+    char input[] = "--input=file.txt";
+    char flag[] = "-f";
+    char first[] = "10";
+    char second[] = "20";
+    char* argv[] = {app, input, flag, first, second};
+
+    ASSERT_TRUE(parser.Parse(5, argv));
+    ASSERT_EQ(parser.GetStringValue("input"), "file.txt");
+    ASSERT_TRUE(parser.GetFlag("flag"));
+    ASSERT_EQ(values.size(), 2);
+    ASSERT_EQ(values[1], 20);
+}
+
+TEST(ArgParserTestSuite, ManyPositionalArgsTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().StoreValues(
+        values);
+
+    std::vector<std::string> args = {"app"};
+    for (int i = 0; i < 100000; ++i) {
+        args.push_back(std::to_string(i));
+    }
+
+    ASSERT_TRUE(parser.Parse(args));
+    ASSERT_EQ(values.size(), 100000);
+    ASSERT_EQ(values[99999], 99999);
+}
+
+TEST(ArgParserTestSuite, ManyOptionsTest) {
+    ArgParser parser("My Parser");
+    for (int i = 0; i < 200; ++i) {
+        parser.AddIntArgument("option" + std::to_string(i));
+    }
+    parser.AddFlag('v', "verbose");
+
+    std::vector<std::string> args = {"app", "-v"};
+    for (int i = 0; i < 200; ++i) {
+        args.push_back("--option" + std::to_string(i) + "=" +
+                       std::to_string(i * 2));
+    }
+
+    ASSERT_TRUE(parser.Parse(args));
+    ASSERT_EQ(parser.GetIntValue("option0"), 0);
+    ASSERT_EQ(parser.GetIntValue("option199"), 398);
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_FALSE(parser.Parse(SplitString("app --option200=1")));
+}
+
+TEST(ArgParserTestSuite, SharedNameKindsTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('n', "number");
+    parser.AddFlag('n', "number");
+    parser.AddStringArgument('s', "number").Default("none");
+
+    // "-n" means the flag, "--number value" and "--number=value" the int
+    ASSERT_TRUE(parser.Parse(SplitString("app -n --number 5 -s=7")));
+    ASSERT_TRUE(parser.GetFlag("number"));
+    ASSERT_EQ(parser.GetIntValue("number"), 7);
+}
+
+TEST(ArgParserTestSuite, SpanSinkTest) {
+    ArgParser parser("My Parser");
+    int buffer[3] = {};
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().StoreValues(
+        std::span<int>(buffer));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 7 8 9")));
+    ASSERT_EQ(buffer[2], 9);
+    ASSERT_EQ(parser.GetIntValue("Param1"), 7);
+    ASSERT_FALSE(parser.Parse(SplitString("app 10")));
+}
+
+TEST(ArgParserTestSuite, DequeSinkTest) {
+    ArgParser parser("My Parser");
+    std::deque<int> values;
+    parser.AddIntArgument('p', "param1").MultiValue(2).StoreValues(values);
+
+    ASSERT_TRUE(
+        parser.Parse(SplitString("app --param1=0 --param1=2 --param1=3")));
+    ASSERT_EQ(values.size(), 3);
+    ASSERT_EQ(values.back(), 3);
+    ASSERT_EQ(parser.GetIntValue("param1"), 0);
+}
+
+TEST(ArgParserTestSuite, StoredValuesAccessTest) {
+    std::vector<int> stored;
+    std::deque<int> listed;
+    Argument vector_argument('a', "vector");
+    vector_argument.MultiValue().StoreValues(stored);
+    Argument deque_argument('d', "deque");
+    deque_argument.MultiValue().StoreValues(listed);
+    for (int value : {4, 5, 6}) {
+        vector_argument.AddIntMulti(value);
+        deque_argument.AddIntMulti(value);
+    }
+
+    ASSERT_EQ(vector_argument.GetStoredValues(), &stored);
+    ASSERT_EQ(vector_argument.GetIntView().size(), 3);
+    ASSERT_EQ(deque_argument.GetStoredValues(), nullptr);
+    ASSERT_EQ(deque_argument.GetIntValues(), std::vector<int>({4, 5, 6}));
+    ASSERT_THROW(deque_argument.GetIntView(), std::logic_error);
+}
+
+TEST(ArgParserTestSuite, ResponseFileTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddStringArgument('i', "input", "File path for input file");
+    parser.AddFlag('f', "flag", "Flag");
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().StoreValues(
+        values);
+
+    {
+        std::ofstream nested("nested_args.rsp");
+        nested << "3\n4\n";
+        std::ofstream outer("args.rsp");
+        outer << "--input=file.txt 1\n\t2 @nested_args.rsp -f";
+    }
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 0 @args.rsp 5")));
+    ASSERT_EQ(parser.GetStringValue("input"), "file.txt");
+    ASSERT_TRUE(parser.GetFlag("flag"));
+    ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    ASSERT_FALSE(parser.Parse(SplitString("app @missing.rsp")));
+
+    std::remove("args.rsp");
+    std::remove("nested_args.rsp");
+}
@@ -0,0 +1,59 @@
+#include "../lib/StaticParser/StaticParser.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace ArgumentParser;
+
+namespace {
+
+std::vector<std::string> Split(const std::string& str) {
+    std::istringstream iss(str);
+
+    return {std::istream_iterator<std::string>(iss),
+            std::istream_iterator<std::string>()};
+}
+
+using BenchParser =
+    StaticArgParser<StringOption<"input", 'i'>, StringOption<"output", 'o'>,
+                    IntOption<"number", '\0', 7>, FlagOption<"sum", 's'>,
+                    FlagOption<"mult", 'm'>, PositionalInts<"N", 1>>;
+
+}  // namespace
+
+TEST(StaticParserTestSuite, TypedResultTest) {
+    BenchParser::Result result;
+    std::vector<std::string> args =
+        Split("app --input=in.txt -o out.txt --number 42 -s 1 2 3");
+
+    ASSERT_TRUE(BenchParser::Parse(args, result));
+    ASSERT_EQ(result.Get<"input">(), "in.txt");
+    ASSERT_EQ(result.Get<"output">(), "out.txt");
+    ASSERT_EQ(result.Get<"number">(), 42);
+    ASSERT_TRUE(result.Get<"sum">());
+    ASSERT_FALSE(result.Get<"mult">());
+    ASSERT_EQ(result.Get<"N">(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(StaticParserTestSuite, DefaultsTest) {
+    BenchParser::Result result;
+    std::vector<std::string> args = Split("app 5");
+
+    ASSERT_TRUE(BenchParser::Parse(args, result));
+    ASSERT_EQ(result.Get<"number">(), 7);
+    ASSERT_FALSE(result.Has<"number">());
+    ASSERT_TRUE(result.Has<"N">());
+    ASSERT_TRUE(result.Get<"input">().empty());
+}
+
+TEST(StaticParserTestSuite, ErrorsTest) {
+    BenchParser::Result result;
+    std::vector<std::string> unknown = Split("app --inputs=x 1");
+    std::vector<std::string> bad_int = Split("app --number=4x 1");
+    std::vector<std::string> no_positional = Split("app -s");
+
+    ASSERT_FALSE(BenchParser::Parse(unknown, result));
+    ASSERT_FALSE(BenchParser::Parse(bad_int, result));
+    ASSERT_FALSE(BenchParser::Parse(no_positional, result));
+}
@@ -0,0 +1,60 @@
+// Fleet dump/load benchmark: places the classic mix of ships (1 x 4, 2 x 3,
+// 3 x 2, 4 x 1 per group) on a square board, then times SaveToFile and
+// LoadFromFile in the text format and in the binary one (".bin").
+//
+//   g++ -std=c++17 -O2 bench/fleet_io_bench.cpp src/*.cpp -o fleet_io_bench
+//   ./fleet_io_bench [side] [groups]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "../incl/battlefield.h"
+#include "../incl/game_info.h"
+#include "../incl/strategy.h"
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    uint64_t side = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    uint64_t groups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+    uint64_t count[4] = {4 * groups, 3 * groups, 2 * groups, groups};
+    BattleField field(side, side);
+    auto start = std::chrono::steady_clock::now();
+    if (!PlaceShips(field, count, 1)) {
+        std::cerr << "Fleet does not fit" << '\n';
+        return 1;
+    }
+    std::cerr << "place\t" << SecondsSince(start) << " s, "
+              << 10 * groups << " ships on " << side << "x" << side << '\n';
+
+    for (const char* name : {"fleet_bench.txt", "fleet_bench.bin"}) {
+        start = std::chrono::steady_clock::now();
+        field.SaveToFile(name);
+        double save = SecondsSince(start);
+
+        GameInfo game_info;
+        BattleField loaded(side, side);
+        start = std::chrono::steady_clock::now();
+        bool ok = loaded.LoadFromFile(name, "master", game_info,
+                                      loaded.battlefield);
+        double load = SecondsSince(start);
+        std::cerr << name << "\tsave " << save << " s, load " << load << " s"
+                  << (ok && loaded.battlefield.GetAliveCells() ==
+                                field.battlefield.GetAliveCells()
+                          ? ""
+                          : " (FAILED)")
+                  << '\n';
+    }
+    return 0;
+}
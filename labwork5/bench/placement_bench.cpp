@@ -0,0 +1,58 @@
+// Fleet placement benchmark: a square board filled with the classic mix of
+// ships (1 x 4, 2 x 3, 3 x 2, 4 x 1 per group) up to the given share of the
+// FleetPlacer::IsFeasible bound, then placed with PlaceEnemyShips.
+//
+//   g++ -std=c++17 -O2 bench/placement_bench.cpp src/*.cpp -o placement_bench
+//   ./placement_bench [side] [percent of the bound...]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../incl/battlefield.h"
+#include "../incl/fleet_placer.h"
+#include "../incl/strategy.h"
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    uint64_t side = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    std::vector<double> percents;
+    for (int i = 2; i < argc; ++i) {
+        percents.push_back(std::atof(argv[i]));
+    }
+    if (percents.empty()) {
+        percents = {10, 30, 50, 70};
+    }
+
+    // One group (4 ships of length 1, 3 of 2, 2 of 3, 1 of 4) takes
+    // 4*2*2 + 3*2*3 + 2*2*4 + 1*2*5 cells of the bound
+    const uint64_t kGroupCells = 16 + 18 + 16 + 10;
+    uint64_t bound = (side + 1) * (side + 1);
+
+    for (double percent : percents) {
+        uint64_t groups =
+            static_cast<uint64_t>(bound * percent / 100) / kGroupCells;
+        uint64_t count[4] = {4 * groups, 3 * groups, 2 * groups, groups};
+        BattleField field(side, side);
+
+        auto start = std::chrono::steady_clock::now();
+        bool placed = PlaceEnemyShips(field, count);
+        double elapsed = SecondsSince(start);
+
+        std::cout << side << "x" << side << "\t" << percent << "% of bound\t"
+                  << 10 * groups << " ships\t"
+                  << (placed ? "placed" : "failed") << "\t"
+                  << elapsed * 1000 << " ms" << std::endl;
+    }
+    return 0;
+}
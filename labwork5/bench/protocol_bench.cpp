@@ -0,0 +1,59 @@
+// Protocol benchmark input: writes the same game as a text session and as a
+// binary one (see incl/protocol.h), to be piped into the bot.
+//
+//   g++ -std=c++17 -O2 bench/protocol_bench.cpp -o protocol_bench
+//   ./protocol_bench [turns] [side]
+//   time ./main < protocol_text.in > /dev/null
+//   time ./main < protocol_binary.in > /dev/null
+//
+// Each turn is our shot, its result and the opponent's shot. Boards past
+// BattleField::kPrintLimit cells are not printed, so a large side measures
+// the protocol itself rather than the board dump after every shot
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void WriteUint64(std::ofstream& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.put(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    uint64_t turns = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    uint64_t side = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+
+    std::string setup = "create slave\nset width " + std::to_string(side) +
+                        "\nset height " + std::to_string(side) +
+                        "\nset count 1 " + std::to_string(side) +
+                        "\nset strategy ordered\nstart\n";
+
+    std::ofstream text("protocol_text.in");
+    std::ofstream binary("protocol_binary.in", std::ios::binary);
+    text << setup;
+    binary << setup << "ping binary\n";
+    for (uint64_t turn = 0; turn < turns; ++turn) {
+        uint64_t x = turn % side;
+        uint64_t y = turn / side % side;
+        text << "shot\nset result miss\nshot " << x << ' ' << y << '\n';
+        binary.put('s');
+        binary.put('r');
+        binary.put('m');
+        binary.put('S');
+        WriteUint64(binary, x);
+        WriteUint64(binary, y);
+    }
+    text << "exit\n";
+    binary.put('q');
+
+    std::cout << "protocol_text.in and protocol_binary.in: " << turns
+              << " turns on " << side << "x" << side << '\n';
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Self-play tournament between two strategies, see incl/tournament.h.
+//
+//   g++ -std=c++17 -O2 -pthread bench/tournament.cpp src/*.cpp -o tournament
+//   ./tournament [master] [slave] [games] [side] [threads] [fleets]
+//
+// The board is side x side with the classic fleet (4 x 1, 3 x 2, 2 x 3,
+// 1 x 4) repeated the given number of times
+
+#include <cstdlib>
+#include <iostream>
+
+#include "../incl/tournament.h"
+
+int main(int argc, char** argv) {
+    TournamentConfig config;
+    if (argc > 1) config.master_strategy = argv[1];
+    if (argc > 2) config.slave_strategy = argv[2];
+    if (argc > 3) config.games = std::atoi(argv[3]);
+    if (argc > 4) {
+        config.width = config.height = std::strtoull(argv[4], nullptr, 10);
+    }
+    if (argc > 5) config.threads = std::atoi(argv[5]);
+    if (argc > 6) {
+        uint64_t fleets = std::strtoull(argv[6], nullptr, 10);
+        for (int i = 0; i < 4; ++i) {
+            config.count[i] *= fleets;
+        }
+    }
+
+    TournamentReport report;
+    if (!RunTournament(config, report)) {
+        std::cerr << "Unknown strategy" << '\n';
+        return 1;
+    }
+
+    std::cout << config.master_strategy << " vs " << config.slave_strategy
+              << " on " << config.width << "x" << config.height << '\n'
+              << "games\t" << report.games << '\n'
+              << "wins\t" << report.master_wins << " / " << report.slave_wins
+              << " (" << report.unfinished << " unfinished)" << '\n'
+              << "shots to win\t" << report.average_shots_to_win << '\n'
+              << "move latency\tp50 " << report.latency_p50 << " us, p90 "
+              << report.latency_p90 << " us, p99 " << report.latency_p99
+              << " us, max " << report.latency_max << " us" << '\n'
+              << "throughput\t" << report.games_per_second << " games/s ("
+              << report.seconds << " s)" << '\n';
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "board.h"
 #include "game_info.h"
 
 class BattleField {
@@ -20,38 +21,40 @@ class BattleField {
     std::vector<Ship> ships;
 
    public:
-    std::vector<std::vector<char>> battlefield;
+    // Bigger boards have no sensible text form
+    static constexpr uint64_t kPrintLimit = uint64_t(1) << 24;
+
+    Board battlefield;
 
     BattleField(uint64_t width, uint64_t height);
 
     //================shoot===============
-    std::string Shoot(uint64_t x, uint64_t y,
-                      std::vector<std::vector<char>>& enemy_battlefield, GameInfo& game_info);
+    std::string Shoot(uint64_t x, uint64_t y, Board& enemy_battlefield);
     //====================================
 
     //================finish===============
-    bool CheckWin(std::vector<std::vector<char>>& enemy_battlefield);
+    bool CheckWin(Board& enemy_battlefield);
     bool CheckLose();
-    bool CheckFinished(std::vector<std::vector<char>>& enemy_battlefield);
+    bool CheckFinished(Board& enemy_battlefield);
     //====================================
 
     //=================put================
     bool PutShip(int length, char type, uint64_t x, uint64_t y,
-                 std::vector<std::vector<char>>& target_field);
+                 Board& target_field);
     //====================================
 
     //==============other==============
     bool IsShipSunk(uint64_t x, uint64_t y,
-                    std::vector<std::vector<char>>& enemy_battlefield);
+                    Board& enemy_battlefield);
 
-    void PrintBattlefield(std::vector<std::vector<char>>& enemy_battlefield);
+    void PrintBattlefield(Board& enemy_battlefield);
     //=================================
 
     //===============io================
     bool SaveToFile(const std::string& filename);
     bool LoadFromFile(const std::string& filename, const std::string player,
                       GameInfo& game_info,
-                      std::vector<std::vector<char>>& battlefield);
+                      Board& battlefield);
     //=================================
 
     // =================geters================
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Cells of one battlefield: '.' - empty, 'S' - ship, 'X' - hit, '*' - miss.
+// Boards up to kDenseLimit cells are two row-major bit planes, ships and
+// shots, with every row padded to whole uint64_t words: a hit is ship &
+// shot, a miss is shot & ~ship. Area and unshot-cell queries then work a
+// word at a time. Bigger boards (the protocol allows sides up to uint64)
+// keep only non-empty cells in a hash map, so memory is proportional to
+// ships plus shots, not to the area
+class Board {
+   private:
+    struct Cell {
+        uint64_t x, y;
+        bool operator==(const Cell& other) const {
+            return x == other.x && y == other.y;
+        }
+    };
+    struct CellHash {
+        size_t operator()(const Cell& cell) const {
+            return static_cast<size_t>(cell.x * 0x9E3779B97F4A7C15ULL ^
+                                       cell.y);
+        }
+    };
+
+    uint64_t width = 0;
+    uint64_t height = 0;
+    bool sparse = false;
+    uint64_t stride = 0;                              // Words per row
+    std::vector<uint64_t> ships;                      // Dense backend
+    std::vector<uint64_t> shots;
+    std::unordered_map<Cell, char, CellHash> marked;  // Sparse backend
+    uint64_t shot_cells = 0;
+
+    // Fleet: every ship cell knows its ship, every ship its unhit cells
+    std::unordered_map<Cell, uint32_t, CellHash> ship_of;
+    std::vector<uint64_t> cells_left;
+    uint64_t alive_cells = 0;
+
+   public:
+    // 2^27 cells is 16 MiB per plane, enough for 10^4 x 10^4
+    static constexpr uint64_t kDenseLimit = uint64_t(1) << 27;
+
+    Board(uint64_t width = 0, uint64_t height = 0);
+
+    // Drops every cell and picks the backend for the new size
+    void Reset(uint64_t width, uint64_t height);
+
+    char Get(uint64_t x, uint64_t y) const;
+    // For shots; ship cells are added with AddShip
+    void Set(uint64_t x, uint64_t y, char value);
+
+    //===============queries===============
+    // No ship cell in the rectangle [x0, x1] x [y0, y1], bounds included
+    // and inside the board. Sparse boards check cell by cell, so there it
+    // is meant for ship halos only
+    bool IsAreaFree(uint64_t x0, uint64_t y0, uint64_t x1, uint64_t y1) const;
+    // Hits plus misses
+    uint64_t CountShots() const { return shot_cells; }
+    // The n-th (from 0, row-major) cell that was not shot yet; dense boards
+    // only, false if there are not that many or the board is sparse
+    bool FindUnshot(uint64_t n, uint64_t& x, uint64_t& y) const;
+    //=====================================
+
+    //================fleet================
+    // Room for a known fleet, so loading it does not rehash
+    void Reserve(uint64_t ship_count, uint64_t ship_cells);
+    // Marks the ship cells 'S'; the placement must already be checked
+    void AddShip(int length, char type, uint64_t x, uint64_t y);
+    // Turns a ship cell into 'X'; true if that sank its ship
+    bool Hit(uint64_t x, uint64_t y);
+    bool IsSunk(uint64_t x, uint64_t y) const;
+    //=====================================
+
+    // =================geters================
+    uint64_t GetWidth() const { return width; }
+    uint64_t GetHeight() const { return height; }
+    bool IsSparse() const { return sparse; }
+    uint64_t GetAliveCells() const { return alive_cells; }
+    //========================================
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "board.h"
+#include "strategy.h"
+
+// Probability-density hunting. For every cell that is still unknown the
+// strategy keeps how many placements of the remaining ship lengths cover
+// it and fires at the maximum, kept at the root of a max segment tree.
+// A miss or a known-empty cell only removes the placements through it, so
+// every shot costs O(log area) per touched cell instead of a rescan. After
+// a hit it finishes the ship along its line; the halo of a sunk ship and
+// the diagonals of every hit are known to be empty and never shot.
+//
+// On huge boards densities are practically uniform, so the hunt there
+// picks random unknown cells and known cells live in a Board
+class DensityStrategy : public Strategy {
+   private:
+    // Cell arrays and the tree take about 13 bytes per cell
+    static constexpr uint64_t kDenseLimit = uint64_t(1) << 24;
+
+    BattleField& battlefield;
+    BattleField& enemy_battlefield;
+    GameInfo& game_info;
+
+    uint64_t width;
+    uint64_t height;
+    bool dense;
+    uint64_t remaining[4];  // Ships left by length
+    std::mt19937_64 random;
+
+    // Dense state: flat arrays indexed by y * width + x
+    std::vector<char> blocked;       // Cannot hold a ship part
+    std::vector<int32_t> density;    // -1 once the cell is known
+    std::vector<uint32_t> tree;      // Max segment tree of cell indices
+    uint32_t leaves = 1;
+
+    // Huge board state: '*' for known cells
+    Board known;
+
+    // Current target: hit cells of a ship that is not sunk yet
+    std::vector<std::pair<uint64_t, uint64_t>> hits;
+
+    // Last shot, waiting for its result in console games
+    bool pending = false;
+    uint64_t last_x = 0;
+    uint64_t last_y = 0;
+    std::string local_result;
+
+    bool IsKnown(uint64_t x, uint64_t y) const;
+    void MarkKnown(uint64_t x, uint64_t y);
+    void Block(uint64_t x, uint64_t y);
+    void Recompute();
+    void UpdateTree(uint32_t cell);
+    void AddPlacement(int length, bool vertical, uint64_t x, uint64_t y,
+                      int32_t delta);
+    bool IsPlacementFree(int length, bool vertical, uint64_t x,
+                         uint64_t y) const;
+
+    bool ChooseTarget(uint64_t& x, uint64_t& y);
+    bool ChooseHunt(uint64_t& x, uint64_t& y);
+
+   public:
+    DensityStrategy(BattleField& enemy_battlefield, BattleField& battlefield,
+                    GameInfo& game_info);
+
+    void Execute() override;
+    bool NextShot(uint64_t& x, uint64_t& y) override;
+    void Observe(const std::string& result) override;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "board.h"
+
+// Random fleet layout where no two ships touch, even by a corner.
+//
+// On a dense board every ship is drawn uniformly from the anchors (cell
+// and orientation) where it still fits. Ships go from the longest; for the
+// current length the valid anchors are kept in an indexed set, and placing
+// a ship removes only the anchors crossing its cells and halo. Huge sparse
+// boards are nearly empty, there a random anchor is checked against the
+// ship cells kept in a sparse Board instead
+class FleetPlacer {
+   private:
+    static constexpr int kAttempts = 16;              // Restarts on a dead end
+    static constexpr int kSparseTriesPerShip = 1000;  // Random anchors per ship
+    static constexpr uint32_t kNone = UINT32_MAX;
+    // Anchor indices are uint32_t and cost 9 bytes per cell
+    static constexpr uint64_t kDenseLimit = uint64_t(1) << 24;
+
+    uint64_t width;
+    uint64_t height;
+    std::mt19937_64 random;
+
+    // Dense state
+    std::vector<char> blocked;       // Ship cells and their halos
+    std::vector<uint32_t> anchors;   // Valid anchors of the current length
+    std::vector<uint32_t> position;  // Index of an anchor in anchors or kNone
+
+    // Sparse state
+    Board occupied;
+
+    bool PlaceDense(const uint64_t count[4]);
+    void CollectAnchors(int length);
+    void RemoveAnchor(uint32_t anchor);
+    void Block(int length, char type, uint64_t x, uint64_t y);
+
+    bool PlaceSparse(const uint64_t count[4]);
+    bool IsFree(int length, char type, uint64_t x, uint64_t y) const;
+
+   public:
+    struct Placement {
+        int length;
+        char type;
+        uint64_t x, y;
+    };
+    std::vector<Placement> placements;
+
+    FleetPlacer(uint64_t width, uint64_t height, uint64_t seed);
+
+    // Quick necessary condition: every ship with a one-cell margin on the
+    // right and bottom takes (length + 1) x 2 cells of a
+    // (width + 1) x (height + 1) board, and the longest ship has to fit
+    bool IsFeasible(const uint64_t count[4]) const;
+
+    // Fills placements; false if the counts are infeasible or no layout
+    // was found within kAttempts
+    bool Place(const uint64_t count[4]);
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 struct GameInfo {
@@ -15,4 +16,5 @@ struct GameInfo {
     std::string file_load = "";
     std::string file_dump = "";
     std::string last_shot_result = "";
+    uint64_t seed = 0;  // Strategy randomness; 0 - seeded from the clock
 };
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "battlefield.h"
+#include "game_info.h"
+
+//=================text=================
+enum class Command {
+    kUnknown,
+    kPing,
+    kExit,
+    kCreate,
+    kStart,
+    kStop,
+    kSet,
+    kGet,
+    kDump,
+    kLoad,
+    kShot,
+    kFinished,
+    kWin,
+    kLose,
+    kHelp,
+};
+
+// Switch on length and first letter, so a command costs one comparison
+Command ParseCommand(std::string_view word);
+
+// Cuts the line at its first space: returns the part before it and leaves
+// the rest in line (empty when there is no space)
+std::string_view NextWord(std::string_view& line);
+
+// Whole text must be a number; false instead of an exception
+bool ParseUint64(std::string_view text, uint64_t& value);
+//======================================
+
+//================binary================
+// Compact framing for bot-vs-bot games, negotiated with "ping binary".
+// The reply "pong binary" is the last text line; after it both sides send
+// frames of one opcode byte and a fixed payload, numbers are uint64
+// little-endian:
+//
+//   'S' x y  - opponent shoots at (x, y)  -> 'm' / 'h' / 'k' / 'f'
+//   's'      - our next shot              -> 'o' x y / 'f'
+//   'r' res  - result of our last shot    -> 'o' / 'f'  (res 'm'/'h'/'k')
+//   'F' 'W' 'L' - finished / win / lose   -> 'y' / 'n'
+//   't'      - back to text commands      -> 'o'
+//   'q'      - exit                       -> 'o'
+//
+// Anything else is answered with 'f'. Game setup (create, set, start)
+// stays in text mode; nothing is printed besides the replies
+namespace binary_protocol {
+constexpr char kShotAt = 'S';
+constexpr char kShot = 's';
+constexpr char kResult = 'r';
+constexpr char kFinished = 'F';
+constexpr char kWin = 'W';
+constexpr char kLose = 'L';
+constexpr char kText = 't';
+constexpr char kExit = 'q';
+
+constexpr char kOk = 'o';
+constexpr char kFailed = 'f';
+constexpr char kYes = 'y';
+constexpr char kNo = 'n';
+constexpr char kMiss = 'm';
+constexpr char kHit = 'h';
+constexpr char kKill = 'k';
+}  // namespace binary_protocol
+
+// Serves frames from std::cin until 't' (returns false) or until 'q' or
+// the end of input (returns true - the program should exit)
+bool RunBinarySession(BattleField* battlefield, BattleField* enemy_battlefield,
+                      GameInfo& game_info);
+//======================================
+
+// Replies are buffered and go out only when the peer is about to wait for
+// them: right before a read that would block
+void FlushIfInputDrained();
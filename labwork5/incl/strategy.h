@@ -6,9 +6,19 @@
 #include "../incl/battlefield.h"
 #include "../incl/game_info.h"
 
+#include <random>
+#include <string>
+
 class Strategy {
    public:
+    // Console turn: picks a cell, shoots the local enemy board and reports
     virtual void Execute() = 0;
+
+    // Console-free turn for in-process games: NextShot picks a cell (false
+    // when nothing is left), Observe gets the result of that shot
+    virtual bool NextShot(uint64_t& x, uint64_t& y) = 0;
+    virtual void Observe(const std::string&) {}
+
     virtual ~Strategy() = default;
 };
 
@@ -30,6 +40,7 @@ class OrderedStrategy : public Strategy {
           current_y(0) {}
 
     void Execute() override;
+    bool NextShot(uint64_t& x, uint64_t& y) override;
 };
 
 class CustomStrategy : public Strategy {
@@ -37,11 +48,30 @@ class CustomStrategy : public Strategy {
     BattleField& battlefield;
     BattleField& enemy_battlefield;
     GameInfo& game_info;
+    std::mt19937_64 random;
+    bool hit = false;
+    uint64_t last_x = 0;
+    uint64_t last_y = 0;
+
+    bool PickUnshot(uint64_t& x, uint64_t& y);
+
    public:
     CustomStrategy(BattleField& enemy_battlefield, BattleField& battlefield, GameInfo& game_info)
-        : enemy_battlefield(enemy_battlefield), battlefield(battlefield), game_info(game_info) {}
+        : battlefield(battlefield),
+          enemy_battlefield(enemy_battlefield),
+          game_info(game_info),
+          random(game_info.seed != 0 ? game_info.seed
+                                     : static_cast<uint64_t>(time(0))) {}
 
     void Execute() override;
+    bool NextShot(uint64_t& x, uint64_t& y) override;
+    void Observe(const std::string& result) override;
 };
 
-bool PlaceEnemyShips(BattleField& enemy_battlefield, const uint64_t count[4]);
\ No newline at end of file
+// "ordered", "custom" or "density"; nullptr for an unknown name
+Strategy* MakeStrategy(const std::string& name, BattleField& enemy_battlefield,
+                       BattleField& battlefield, GameInfo& game_info);
+
+bool PlaceEnemyShips(BattleField& enemy_battlefield, const uint64_t count[4]);
+// Same with a fixed seed, for reproducible games
+bool PlaceShips(BattleField& field, const uint64_t count[4], uint64_t seed);
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Self-play between two strategies without console I/O. Each game places
+// both fleets from its own seed, then master and slave shoot in turns
+// through Strategy::NextShot / BattleField::Shoot / Strategy::Observe
+// until one side has no ship cells left. Games run on a pool of threads
+// that take them in batches
+struct TournamentConfig {
+    std::string master_strategy = "density";
+    std::string slave_strategy = "custom";
+    uint64_t width = 10;
+    uint64_t height = 10;
+    uint64_t count[4] = {4, 3, 2, 1};
+    int games = 1000;
+    int threads = 0;  // 0 - one per hardware thread
+    int batch = 16;   // Games a worker takes at once
+    uint64_t seed = 1;
+};
+
+struct GameRecord {
+    int winner = -1;     // 0 - master, 1 - slave, -1 - not finished
+    uint64_t shots = 0;  // Shots of the winner
+};
+
+struct TournamentReport {
+    int games = 0;
+    int master_wins = 0;
+    int slave_wins = 0;
+    int unfinished = 0;
+    double average_shots_to_win = 0;
+    // Time of one move (pick, shoot, observe) in microseconds
+    double latency_p50 = 0;
+    double latency_p90 = 0;
+    double latency_p99 = 0;
+    double latency_max = 0;
+    double seconds = 0;
+    double games_per_second = 0;
+};
+
+// One game; the latency of every move is appended to latencies
+GameRecord PlaySelfGame(const TournamentConfig& config, uint64_t seed,
+                        std::vector<float>& latencies);
+
+// False if a strategy name is unknown
+bool RunTournament(const TournamentConfig& config, TournamentReport& report);
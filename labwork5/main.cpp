@@ -1,8 +1,10 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "incl/battlefield.h"
 #include "incl/game_info.h"
+#include "incl/protocol.h"
 #include "incl/strategy.h"
 #include "incl/strategy_manager.h"
 
@@ -15,46 +17,74 @@ void PrintHelp() {
     std::cout << "  set height <value> - Set the height of the battlefield\n";
     std::cout << "  set count <type> <count> - Set the count of ships of a "
                  "specific type\n";
-    std::cout << "  set strategy ordered/custom - Set the strategy\n";
+    std::cout << "  set strategy ordered/custom/density - Set the strategy\n";
     std::cout << "  get width - Get the width of the battlefield\n";
     std::cout << "  get height - Get the height of the battlefield\n";
     std::cout
         << "  get count <type> - Get the count of ships of a specific type\n";
-    std::cout << "  dump <filename> - Save the battlefield to a file\n";
+    std::cout << "  dump <filename> - Save the battlefield to a file (binary "
+                 "if it ends in .bin)\n";
     std::cout << "  load <filename> - Load the battlefield from a file\n";
     std::cout << "  shot <x> <y> - Shoot at the specified coordinates\n";
     std::cout << "  shot - Execute the strategy's shot\n";
     std::cout << "  finished - Check if the game is finished\n";
     std::cout << "  win - Check if you have won\n";
     std::cout << "  lose - Check if you have lost\n";
+    std::cout << "  ping binary - Switch to binary frames (see protocol.h)\n";
     std::cout << "  help - Show this help message\n";
     std::cout << "  exit - Exit the program\n";
 }
 
+void PrintUnknownCommand() {
+    std::cerr << '\n'
+              << "You can't start game! /\nYou need to create game first! /\n"
+              << "If you slave you can't set parametrs! /" << '\n'
+              << "Unknown command!" << '\n'
+              << "Type 'help' to see available commands." << '\n'
+              << '\n';
+}
+
 int main() {
+    // Replies are flushed by FlushIfInputDrained, not per line
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
     GameInfo game_info;
     BattleField* battlefield = nullptr;
     BattleField* enemy_battlefield = nullptr;
     StrategyManager::SetStrategy(
         new CustomStrategy(*battlefield, *enemy_battlefield, game_info));
     game_info.strategy = "custom";
+    std::string cmd;
     while (true) {
-        std::string cmd;
-        std::getline(std::cin, cmd);
+        FlushIfInputDrained();
+        bool exit = !std::getline(std::cin, cmd);
 
-        size_t pos = cmd.find(' ');
-        std::string command = cmd.substr(0, pos);
-        std::string args =
-            (pos == std::string::npos) ? "" : cmd.substr(pos + 1);
+        std::string_view args = cmd;
+        Command command = exit ? Command::kExit : ParseCommand(NextWord(args));
 
-        if (command == "exit") {
+        switch (command) {
+        case Command::kExit:
             delete battlefield;
             delete enemy_battlefield;
             delete StrategyManager::GetStrategy();
             return 0;
-        } else if (command == "ping") {
-            std::cout << "pong" << '\n';
-        } else if (command == "create") {
+        case Command::kPing:
+            if (args == "binary") {
+                std::cout << "pong binary" << '\n';
+                if (RunBinarySession(battlefield, enemy_battlefield,
+                                     game_info)) {
+                    std::cout.flush();
+                    delete battlefield;
+                    delete enemy_battlefield;
+                    delete StrategyManager::GetStrategy();
+                    return 0;
+                }
+            } else {
+                std::cout << "pong" << '\n';
+            }
+            break;
+        case Command::kCreate:
             if (args == "master") {
                 std::cout << "ok" << '\n';
                 game_info.opponent = "master";
@@ -86,7 +116,8 @@ int main() {
                 game_info.count[3] = 0 + rand() % (5 +1 );
             */
             }
-        } else if (command == "start") {
+            break;
+        case Command::kStart:
             if (game_info.started && !game_info.end_game) {
                 std::cout << "ok" << '\n';
             }
@@ -140,46 +171,46 @@ int main() {
             }
 
             // Set strategy
-            if (game_info.strategy == "ordered") {
-                StrategyManager::SetStrategy(
-                    new OrderedStrategy(*battlefield, *enemy_battlefield, game_info));
-            } else {
-                StrategyManager::SetStrategy(
-                    new CustomStrategy(*battlefield, *enemy_battlefield, game_info));
-            }
+            StrategyManager::SetStrategy(MakeStrategy(
+                game_info.strategy, *battlefield, *enemy_battlefield, game_info));
 
             // Print battlefield
             battlefield->PrintBattlefield(enemy_battlefield->battlefield);
-            continue;
-        } else if (command == "stop") {
+            break;
+        case Command::kStop:
             std::cout << "ok" << '\n';
             game_info.end_game = true;
             delete battlefield;
             delete enemy_battlefield;
             battlefield = nullptr;
             enemy_battlefield = nullptr;
+            break;
 
             // SET ARGUMENTS
-        } else if (command == "set" && game_info.started) {
-            size_t first_space = args.find(' ');
-            if (first_space == std::string::npos) {
+        case Command::kSet: {
+            if (!game_info.started) {
+                PrintUnknownCommand();
+                break;
+            }
+            std::string_view value = args;
+            std::string_view key = NextWord(value);
+            if (value.empty()) {
                 std::cerr << '\n' << "failed" << '\n';
+                break;
             }
 
-            std::string key = args.substr(0, first_space);
-            std::string value = args.substr(first_space + 1);
-
+            uint64_t number = 0;
             if (key == "width" && game_info.player == "master") {
-                if (std::stoull(value) > 0) {
-                    game_info.width = std::stoull(value);
+                if (ParseUint64(value, number) && number > 0) {
+                    game_info.width = number;
                     std::cout << "ok" << '\n';
                 } else {
                     std::cerr << '\n'
                               << "Argument must be positive. Failed" << '\n';
                 }
             } else if (key == "height" && game_info.player == "master") {
-                if (std::stoull(value) > 0) {
-                    game_info.height = std::stoull(value);
+                if (ParseUint64(value, number) && number > 0) {
+                    game_info.height = number;
                     std::cout << "ok" << '\n';
                 } else {
                     std::cerr << '\n'
@@ -188,19 +219,13 @@ int main() {
 
                 // COUNT
             } else if (key == "count" && game_info.player == "master") {
-                size_t second_space = value.find(' ');
-                if (second_space == std::string::npos) {
-                    std::cerr << "failed" << '\n' << '\n';
-                }
+                std::string_view count_str = value;
+                std::string_view type_str = NextWord(count_str);
 
-                std::string type_str = value.substr(0, second_space);
-                std::string count_str = value.substr(second_space + 1);
-
-                int type = std::stoull(type_str);
-                uint64_t count = std::stoull(count_str);
-
-                if (type >= 1 && type <= 4 && count > 0) {
-                    game_info.count[type - 1] = count;
+                uint64_t type = 0;
+                if (ParseUint64(type_str, type) && type >= 1 && type <= 4 &&
+                    ParseUint64(count_str, number) && number > 0) {
+                    game_info.count[type - 1] = number;
                     std::cout << "ok" << '\n';
                 } else {
                     std::cerr << '\n'
@@ -208,44 +233,40 @@ int main() {
                               << '\n';
                 }
             } else if (key == "strategy") {
-                if (value == "ordered") {
-                    std::cout << "ok" << '\n';
-                    game_info.strategy = value;
-                } else if (value == "custom") {
+                if (value == "ordered" || value == "custom" ||
+                    value == "density") {
                     std::cout << "ok" << '\n';
                     game_info.strategy = value;
                 }
             } else if (key == "result" && game_info.enemy_shot_done == true) {
-                if (value == "hit") {
-                    game_info.last_shot_result = "hit";
-                } else if (value == "miss") {
-                    game_info.last_shot_result = "miss";
-                } else if (value == "kill") {
-                    game_info.last_shot_result = "kill";
+                if (value == "hit" || value == "miss" || value == "kill") {
+                    game_info.last_shot_result = value;
                 } else {
                     std::cerr << '\n' << "Invalid argument. Failed" << '\n'
                               << '\n';
                 }
-            
             } else {
                 std::cerr << '\n' << "Invalid argument. Failed" << '\n' << '\n';
             }
+            break;
+        }
 
             // GET ARGUMENTS
-        } else if (command == "get" && game_info.started) {
-            size_t first_space = args.find(' ');
-
-            std::string key = args.substr(0, first_space);
+        case Command::kGet: {
+            if (!game_info.started) {
+                PrintUnknownCommand();
+                break;
+            }
+            std::string_view value = args;
+            std::string_view key = NextWord(value);
 
             if (key == "width") {
                 std::cout << game_info.width << '\n';
             } else if (key == "height") {
                 std::cout << game_info.height << '\n';
             } else if (key == "count") {
-                std::string value = args.substr(first_space + 1);
-                int type = std::stoi(value);
-
-                if (type >= 1 && type <= 4) {
+                uint64_t type = 0;
+                if (ParseUint64(value, type) && type >= 1 && type <= 4) {
                     std::cout << game_info.count[type - 1] << '\n';
                 } else {
                     std::cerr << '\n'
@@ -253,18 +274,25 @@ int main() {
                               << '\n';
                 }
             }
+            break;
+        }
 
-        } else if (command == "dump" && game_info.started) {
-            if (battlefield && !args.empty()) {
+        case Command::kDump:
+            if (!game_info.started) {
+                PrintUnknownCommand();
+            } else if (battlefield && !args.empty()) {
                 game_info.file_dump = args;
                 std::cout << "ok" << '\n';
                 battlefield->SaveToFile(game_info.file_dump);
             } else {
                 std::cerr << '\n' << "Failed to dump" << '\n' << '\n';
             }
+            break;
 
-        } else if (command == "load" && game_info.started) {
-            if (!args.empty()) {
+        case Command::kLoad:
+            if (!game_info.started) {
+                PrintUnknownCommand();
+            } else if (!args.empty()) {
                 game_info.load_from_file = true;
                 game_info.file_load = args;
                 if (!battlefield) {
@@ -286,12 +314,15 @@ int main() {
                           << "File name is empty. Failed to load!" << '\n'
                           << '\n';
             }
+            break;
 
-        } else if (command == "shot" && game_info.started) {
-            if (args == "") {  // EnemyShoot
+        case Command::kShot:
+            if (!game_info.started) {
+                PrintUnknownCommand();
+            } else if (args.empty()) {  // EnemyShoot
                 if (!battlefield || !enemy_battlefield) {
                     std::cerr << "Battlefields are not initialized!" << '\n';
-                    continue;
+                    break;
                 }
                 Strategy* strategy = StrategyManager::GetStrategy();
                 if (strategy) {
@@ -299,45 +330,45 @@ int main() {
                 }
                 battlefield->PrintBattlefield(enemy_battlefield->battlefield);
                 game_info.enemy_shot_done = true;
-            } else if (game_info.enemy_shot_done == true && args != "") {
-                size_t first_space = args.find(' ');
-                if (first_space == std::string::npos) {
+            } else if (game_info.enemy_shot_done == true) {
+                std::string_view y_str = args;
+                std::string_view x_str = NextWord(y_str);
+                uint64_t x, y;
+                if (!ParseUint64(x_str, x) || !ParseUint64(y_str, y)) {
                     std::cerr << "failed" << '\n';
-                    continue;
+                    break;
                 }
-                std::string x_str = args.substr(0, first_space);
-                std::string y_str = args.substr(first_space + 1);
-                uint64_t x = std::stoull(x_str);
-                uint64_t y = std::stoull(y_str);
                 std::string result =
-                    battlefield->Shoot(x, y, enemy_battlefield->battlefield, game_info);
+                    battlefield->Shoot(x, y, enemy_battlefield->battlefield);
                 battlefield->PrintBattlefield(enemy_battlefield->battlefield);
                 std::cout << '\n' << result << '\n';
                 game_info.enemy_shot_done = false;
             }
-        } else if (command == "finished") {
+            break;
+
+        case Command::kFinished:
             std::cout << (battlefield && battlefield->CheckFinished(
                                              enemy_battlefield->battlefield))
                       << '\n';
+            break;
 
-        } else if (command == "win") {
+        case Command::kWin:
             std::cout << (battlefield &&
                           battlefield->CheckWin(enemy_battlefield->battlefield))
                       << '\n';
+            break;
 
-        } else if (command == "lose") {
+        case Command::kLose:
             std::cout << (battlefield && battlefield->CheckLose()) << '\n';
+            break;
 
-        } else if (command == "help") { 
+        case Command::kHelp:
             PrintHelp();
-        } else {
-            std::cerr
-                << '\n'
-                << "You can't start game! /\nYou need to create game first! /\n"
-                << "If you slave you can't set parametrs! /" << '\n'
-                << "Unknown command!" << '\n'
-                << "Type 'help' to see available commands." << '\n'
-                << '\n';
+            break;
+
+        case Command::kUnknown:
+            PrintUnknownCommand();
+            break;
         }
     }
 
@@ -1,6 +1,9 @@
 #include "../incl/battlefield.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <charconv>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -11,65 +14,24 @@
 BattleField::BattleField(uint64_t width, uint64_t height)
     : width(width),
       height(height),
-      battlefield(height, std::vector<char>(width, '.')) {}
+      battlefield(width, height) {}
 //========================================
 //============Check kill/not==============
-bool BattleField::IsShipSunk(
-    uint64_t x, uint64_t y, std::vector<std::vector<char>>& enemy_battlefield) {
-    uint64_t start_x = x;
-    while (start_x > 0 && (enemy_battlefield[y][start_x - 1] == 'S' ||
-                           enemy_battlefield[y][start_x - 1] == 'X')) {
-        --start_x;
-    }
-    uint64_t end_x = x;
-    while (end_x < enemy_battlefield[0].size() - 1 &&
-           (enemy_battlefield[y][end_x + 1] == 'S' ||
-            enemy_battlefield[y][end_x + 1] == 'X')) {
-        ++end_x;
-    }
-    for (uint64_t i = start_x; i <= end_x; ++i) {
-        if (enemy_battlefield[y][i] == 'S') {
-            return false;
-        }
-    }
-
-    uint64_t start_y = y;
-    while (start_y > 0 && (enemy_battlefield[start_y - 1][x] == 'S' ||
-                           enemy_battlefield[start_y - 1][x] == 'X')) {
-        --start_y;
-    }
-    uint64_t end_y = y;
-    while (end_y < enemy_battlefield.size() - 1 &&
-           (enemy_battlefield[end_y + 1][x] == 'S' ||
-            enemy_battlefield[end_y + 1][x] == 'X')) {
-        ++end_y;
-    }
-    for (uint64_t i = start_y; i <= end_y; ++i) {
-        if (enemy_battlefield[i][x] == 'S') {
-            return false;
-        }
-    }
-
-    return true;
+bool BattleField::IsShipSunk(uint64_t x, uint64_t y, Board& enemy_battlefield) {
+    return enemy_battlefield.IsSunk(x, y);
 }
 //========================================
 //===============shoot================
-std::string BattleField::Shoot(
-    uint64_t x, uint64_t y, std::vector<std::vector<char>>& enemy_battlefield, GameInfo& game_info) {
+std::string BattleField::Shoot(uint64_t x, uint64_t y,
+                               Board& enemy_battlefield) {
     if (x >= width || y >= height) {
         throw std::invalid_argument("Shot coordinates are out of bounds.");
     }
 
-    if (enemy_battlefield[y][x] == 'S') {
-        enemy_battlefield[y][x] = 'X';
-        if (game_info.last_shot_result == "kill") { //!!!!!!!!!!!!!!!!!!!
-            shot_result = "kill";
-        } else if (game_info.last_shot_result == "hit") {
-            shot_result = "hit";
-        }
-
-    } else if (enemy_battlefield[y][x] == '.') {
-        enemy_battlefield[y][x] = '*';
+    if (enemy_battlefield.Get(x, y) == 'S') {
+        shot_result = enemy_battlefield.Hit(x, y) ? "kill" : "hit";
+    } else if (enemy_battlefield.Get(x, y) == '.') {
+        enemy_battlefield.Set(x, y, '*');
         shot_result = "miss";
     } else {
         shot_result = "already shot";
@@ -81,13 +43,9 @@ std::string BattleField::Shoot(
 
 //===============checking win/lose===============
 // Check win
-bool BattleField::CheckWin(std::vector<std::vector<char>>& enemy_battlefield) {
-    for (uint64_t y = 0; y < height; ++y) {
-        for (uint64_t x = 0; x < width; ++x) {
-            if (enemy_battlefield[y][x] == 'S') {
-                return false;
-            }
-        }
+bool BattleField::CheckWin(Board& enemy_battlefield) {
+    if (enemy_battlefield.GetAliveCells() > 0) {
+        return false;
     }
     result_match = "win";
     std::cout << "You win!" << '\n';
@@ -96,12 +54,8 @@ bool BattleField::CheckWin(std::vector<std::vector<char>>& enemy_battlefield) {
 
 // Check lose
 bool BattleField::CheckLose() {
-    for (uint64_t y = 0; y < height; ++y) {
-        for (uint64_t x = 0; x < width; ++x) {
-            if (battlefield[y][x] == 'S') {
-                return false;
-            }
-        }
+    if (battlefield.GetAliveCells() > 0) {
+        return false;
     }
     std::cout << "You lose!" << '\n';
     result_match = "lose";
@@ -110,7 +64,7 @@ bool BattleField::CheckLose() {
 
 // Check finished
 bool BattleField::CheckFinished(
-    std::vector<std::vector<char>>& enemy_battlefield) {
+    Board& enemy_battlefield) {
     if (CheckWin(enemy_battlefield) || CheckLose()) {
         std::cout << "Finished!" << '\n';
         result_match = "finished";
@@ -122,12 +76,17 @@ bool BattleField::CheckFinished(
 
 //===============put===============
 bool BattleField::PutShip(int length, char type, uint64_t x, uint64_t y,
-                          std::vector<std::vector<char>>& target_field) {
+                          Board& target_field) {
     if (type != 'h' && type != 'v') {
         std::cerr << '\n' << "Invalid type of ship!" << '\n' << '\n';
         return false;
     }
 
+    if (length < 1 || length > 4) {
+        std::cerr << '\n' << "Invalid length of ship!" << '\n' << '\n';
+        return false;
+    }
+
     if (x >= width || y >= height) {
         std::cerr << '\n' << "Coordinates are out of bounds!" << '\n' << '\n';
         return false;
@@ -139,23 +98,20 @@ bool BattleField::PutShip(int length, char type, uint64_t x, uint64_t y,
         return false;
     }
 
-    for (uint64_t i = 0; i < length; ++i) {
-        uint64_t nx = (type == 'h') ? x + i : x;
-        uint64_t ny = (type == 'h') ? y : y + i;
-
-        if (target_field[ny][nx] != '.') {
-            std::cerr << '\n' << "Invalid ship placement!" << '\n' << '\n';
-            return false;
-        }
+    // Ships never touch, not even by a corner
+    uint64_t right = (type == 'h') ? x + length : x + 1;
+    uint64_t bottom = (type == 'h') ? y + 1 : y + length;
+    if (!target_field.IsAreaFree(x > 0 ? x - 1 : 0, y > 0 ? y - 1 : 0,
+                                 right < width ? right : width - 1,
+                                 bottom < height ? bottom : height - 1)) {
+        std::cerr << '\n'
+                  << "Invalid ship placement: ships are too close!" << '\n'
+                  << '\n';
+        return false;
     }
 
     // Put the ship
-    for (uint64_t i = 0; i < length; ++i) {
-        uint64_t nx = (type == 'h') ? x + i : x;
-        uint64_t ny = (type == 'h') ? y : y + i;
-
-        target_field[ny][nx] = 'S';
-    }
+    target_field.AddShip(length, type, x, y);
 
     Ship new_ship = {length, type, x, y};
     ships.push_back(new_ship);
@@ -165,12 +121,19 @@ bool BattleField::PutShip(int length, char type, uint64_t x, uint64_t y,
 
 // Print battlefield
 void BattleField::PrintBattlefield(
-    std::vector<std::vector<char>>& enemy_battlefield) {
-    int width = battlefield[0].size();
-    int height = battlefield.size();
+    Board& enemy_battlefield) {
+    if (battlefield.GetWidth() == 0 || enemy_battlefield.GetWidth() == 0 ||
+        battlefield.GetHeight() > kPrintLimit / battlefield.GetWidth() ||
+        enemy_battlefield.GetHeight() >
+            kPrintLimit / enemy_battlefield.GetWidth()) {
+        std::cout << "Battlefield is too large to print" << '\n';
+        return;
+    }
+    int width = battlefield.GetWidth();
+    int height = battlefield.GetHeight();
 
     std::cout << "Your Battlefield:               Enemy's Battlefield:"
-              << std::endl;
+              << '\n';
 
     std::cout << "     ";
     for (int i = 0; i < width; ++i) {
@@ -180,41 +143,141 @@ void BattleField::PrintBattlefield(
     for (int i = 0; i < width; ++i) {
         std::cout << std::setw(2) << i << " ";
     }
-    std::cout << std::endl;
+    std::cout << '\n';
 
     for (int y = 0; y < height; ++y) {
         std::cout << std::setw(2) << y << " ";
         for (int x = 0; x < width; ++x) {
-            std::cout << std::setw(2) << battlefield[y][x] << " ";
+            std::cout << std::setw(2) << battlefield.Get(x, y) << " ";
         }
 
         std::cout << "     " << std::setw(2) << y << " ";
         for (int x = 0; x < width; ++x) {
-            if (enemy_battlefield[y][x] == 'X' ||
-                enemy_battlefield[y][x] == '*') {
-                std::cout << std::setw(2) << enemy_battlefield[y][x] << " ";
+            if (enemy_battlefield.Get(x, y) == 'X' ||
+                enemy_battlefield.Get(x, y) == '*') {
+                std::cout << std::setw(2) << enemy_battlefield.Get(x, y) << " ";
             } else {
                 std::cout << std::setw(2) << '.' << " ";
             }
         }
-        std::cout << std::endl;
+        std::cout << '\n';
     }
 }
 
 //=====================io=====================
-bool BattleField::SaveToFile(const std::string& filename) {
-    std::ofstream out_file(filename);
-    if (!out_file.is_open()) {
-        std::cerr << "Failed to open file!" << '\n';
+namespace {
+
+// Binary fleet: the magic, then width, height and the number of ships as
+// uint64 little-endian, then per ship x and y (uint64), length and 'h'/'v'
+const char kFleetMagic[8] = {'B', 'S', 'F', 'L', 'E', 'E', 'T', '1'};
+const size_t kFleetHeader = sizeof(kFleetMagic) + 3 * 8;
+const size_t kShipRecord = 8 + 8 + 1 + 1;
+
+bool IsBinaryName(const std::string& filename) {
+    return filename.size() >= 4 &&
+           filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+void PutUint64(char* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+uint64_t GetUint64(const char* data) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = value << 8 | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+void AppendNumber(std::string& data, uint64_t value) {
+    char digits[20];
+    data.append(digits, std::to_chars(digits, digits + 20, value).ptr);
+}
+
+// The whole file with one read
+bool ReadFile(const std::string& filename, std::string& data) {
+    std::ifstream in_file(filename, std::ios::binary | std::ios::ate);
+    if (!in_file.is_open()) {
         return false;
     }
+    std::streamsize size = in_file.tellg();
+    data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    in_file.seekg(0);
+    return static_cast<bool>(in_file.read(&data[0], data.size()));
+}
+
+// Text fields separated by any whitespace, like operator>>
+void SkipSpaces(const char*& pos, const char* end) {
+    while (pos != end && std::isspace(static_cast<unsigned char>(*pos))) {
+        ++pos;
+    }
+}
 
-    out_file << width << " " << height << '\n';
+bool ParseNumber(const char*& pos, const char* end, uint64_t& value) {
+    SkipSpaces(pos, end);
+    auto [ptr, error] = std::from_chars(pos, end, value);
+    if (error != std::errc()) {
+        return false;
+    }
+    pos = ptr;
+    return true;
+}
 
-    for (size_t i = 0; i < ships.size(); ++i) {
-        const Ship& ship = ships[i];
-        out_file << ship.length << " " << ship.type << " " << ship.x << " "
-                 << ship.y << '\n';
+bool ParseChar(const char*& pos, const char* end, char& value) {
+    SkipSpaces(pos, end);
+    if (pos == end) {
+        return false;
+    }
+    value = *pos++;
+    return true;
+}
+
+}  // namespace
+
+// Text unless the name ends in ".bin"; either way the file is built in
+// memory and written at once
+bool BattleField::SaveToFile(const std::string& filename) {
+    std::string data;
+    if (IsBinaryName(filename)) {
+        data.resize(kFleetHeader + ships.size() * kShipRecord);
+        char* out = &data[0];
+        std::copy(kFleetMagic, kFleetMagic + sizeof(kFleetMagic), out);
+        PutUint64(out + 8, width);
+        PutUint64(out + 16, height);
+        PutUint64(out + 24, ships.size());
+        out += kFleetHeader;
+        for (const Ship& ship : ships) {
+            PutUint64(out, ship.x);
+            PutUint64(out + 8, ship.y);
+            out[16] = static_cast<char>(ship.length);
+            out[17] = ship.type;
+            out += kShipRecord;
+        }
+    } else {
+        data.reserve(48 + ships.size() * 24);
+        AppendNumber(data, width);
+        data += ' ';
+        AppendNumber(data, height);
+        data += '\n';
+        for (const Ship& ship : ships) {
+            AppendNumber(data, ship.length);
+            data += ' ';
+            data += ship.type;
+            data += ' ';
+            AppendNumber(data, ship.x);
+            data += ' ';
+            AppendNumber(data, ship.y);
+            data += '\n';
+        }
+    }
+
+    std::ofstream out_file(filename, std::ios::binary);
+    if (!out_file.is_open() || !out_file.write(data.data(), data.size())) {
+        std::cerr << "Failed to open file!" << '\n';
+        return false;
     }
 
     out_file.close();
@@ -222,22 +285,56 @@ bool BattleField::SaveToFile(const std::string& filename) {
     return true;
 }
 
+// Binary files are recognized by the magic, not by the name
 bool BattleField::LoadFromFile(const std::string& filename,
                                const std::string player, GameInfo& game_info,
-                               std::vector<std::vector<char>>& battlefield) {
-    std::ifstream in_file(filename);
-    if (!in_file.is_open()) {
+                               Board& battlefield) {
+    std::string data;
+    if (!ReadFile(filename, data)) {
         std::cerr << "Failed to open file!" << '\n';
         return false;
     }
+    const char* pos = data.data();
+    const char* end = pos + data.size();
+
+    uint64_t file_width = 0;
+    uint64_t file_height = 0;
+    uint64_t ship_count = 0;
+    bool binary = data.size() >= sizeof(kFleetMagic) &&
+                  std::equal(kFleetMagic, kFleetMagic + sizeof(kFleetMagic),
+                             pos);
+    if (binary) {
+        if (data.size() < kFleetHeader ||
+            GetUint64(pos + 24) != (data.size() - kFleetHeader) / kShipRecord ||
+            (data.size() - kFleetHeader) % kShipRecord != 0) {
+            std::cerr << "Broken binary fleet file!" << '\n';
+            return false;
+        }
+        file_width = GetUint64(pos + 8);
+        file_height = GetUint64(pos + 16);
+        ship_count = GetUint64(pos + 24);
+        pos += kFleetHeader;
+    } else {
+        // The header is optional: "1 h 0 0" starts a headerless fleet
+        const char* first = pos;
+        bool header = ParseNumber(pos, end, file_width) &&
+                      ParseNumber(pos, end, file_height);
+        SkipSpaces(pos, end);
+        if (!header ||
+            (pos != end && std::isalpha(static_cast<unsigned char>(*pos)))) {
+            file_width = file_height = 0;
+            pos = first;
+        }
+    }
 
     if (player == "master") {
         if (game_info.width == 0 || game_info.height == 0) {
-            if (!(in_file >> game_info.width >> game_info.height) ||
-                game_info.width <= 0 || game_info.height <= 0) {
+            if (file_width == 0 || file_height == 0) {
                 std::cerr << "Failed to read valid width and height!" << '\n';
                 return false;
             }
+            game_info.width = file_width;
+            game_info.height = file_height;
         }
         width = game_info.width;
         height = game_info.height;
@@ -255,74 +352,58 @@ bool BattleField::LoadFromFile(const std::string& filename,
         return false;
     }
 
-    if (!battlefield.empty()) {
-        battlefield.clear();
-    }
-
-    battlefield = std::vector<std::vector<char>>(
-        game_info.height, std::vector<char>(game_info.width, '.'));
+    battlefield.Reset(game_info.width, game_info.height);
+    ships.clear();
     std::cout << "Battlefield initialized: width=" << width
               << ", height=" << height << '\n';
 
-    std::vector<std::pair<uint64_t, uint64_t>> occupied_coords;
-
+    // PutShip checks the bounds and the halo on the ship plane
     uint64_t length;
     char orientation;
     uint64_t x, y;
-
-    while (in_file >> length >> orientation >> x >> y) {
-        bool valid_placement = true;
-
-        for (uint64_t i = 0; i < length; ++i) {
-            uint64_t nx = (orientation == 'h') ? x + i : x;
-            uint64_t ny = (orientation == 'h') ? y : y + i;
-
-            if (nx >= width || ny >= height) {
-                std::cerr << "Invalid ship placement: out of bounds!\n";
-                valid_placement = false;
-                break;
-            }
-
-            for (int dx = -1; dx <= 1; ++dx) {
-                for (int dy = -1; dy <= 1; ++dy) {
-                    uint64_t adj_x = nx + dx;
-                    uint64_t adj_y = ny + dy;
-
-                    if (adj_x < width && adj_y < height &&
-                        std::find(occupied_coords.begin(),
-                                  occupied_coords.end(),
-                                  std::make_pair(adj_x, adj_y)) !=
-                            occupied_coords.end()) {
-                        std::cerr
-                            << "Invalid ship placement: ships are too close!\n";
-                        valid_placement = false;
-                        break;
-                    }
-                }
-                if (!valid_placement) break;
-            }
+    if (binary) {
+        uint64_t ship_cells = 0;
+        for (uint64_t i = 0; i < ship_count; ++i) {
+            ship_cells += static_cast<unsigned char>(pos[i * kShipRecord + 16]);
         }
-
-        if (!valid_placement) {
-            std::cerr << "Failed to place ship: " << length << " "
-                      << orientation << " " << x << " " << y << '\n';
-            return false;
+        battlefield.Reserve(ship_count, ship_cells);
+        ships.reserve(ship_count);
+        for (uint64_t i = 0; i < ship_count; ++i, pos += kShipRecord) {
+            x = GetUint64(pos);
+            y = GetUint64(pos + 8);
+            length = static_cast<unsigned char>(pos[16]);
+            orientation = pos[17];
+            if (length < 1 || length > 4 ||
+                !PutShip(length, orientation, x, y, battlefield)) {
+                std::cerr << "Failed to place ship: " << length << " "
+                          << orientation << " " << x << " " << y << '\n';
+                return false;
+            }
         }
-
-        if (PutShip(length, orientation, x, y, battlefield)) {
-            for (uint64_t i = 0; i < length; ++i) {
-                uint64_t nx = (orientation == 'h') ? x + i : x;
-                uint64_t ny = (orientation == 'h') ? y : y + i;
-                occupied_coords.emplace_back(nx, ny);
+    } else {
+        // A ship per line, two cells per ship in the classic fleet
+        uint64_t lines = std::count(pos, end, '\n');
+        battlefield.Reserve(lines, 2 * lines);
+        ships.reserve(lines);
+        while (ParseNumber(pos, end, length) &&
+               ParseChar(pos, end, orientation) && ParseNumber(pos, end, x) &&
+               ParseNumber(pos, end, y)) {
+            // PutShip takes an int length, so range-check before narrowing
+            if (length < 1 || length > 4 ||
+                !PutShip(length, orientation, x, y, battlefield)) {
+                std::cerr << "Failed to place ship: " << length << " "
+                          << orientation << " " << x << " " << y << '\n';
+                return false;
             }
-        } else {
-            std::cerr << "Failed to place ship: " << length << " "
-                      << orientation << " " << x << " " << y << '\n';
+        }
+        SkipSpaces(pos, end);
+        if (pos != end) {
+            std::cerr << "Broken fleet file near: "
+                      << std::string(pos, std::find(pos, end, '\n')) << '\n';
             return false;
         }
     }
 
-    in_file.close();
     std::cout << "Loaded successfully!" << '\n';
     return true;
 }
@@ -0,0 +1,162 @@
+#include "../incl/board.h"
+
+//==============Сonstructor===============
+Board::Board(uint64_t width, uint64_t height) { Reset(width, height); }
+
+void Board::Reset(uint64_t width, uint64_t height) {
+    this->width = width;
+    this->height = height;
+    // Division keeps the check safe from overflow of width * height
+    sparse = width != 0 && height > kDenseLimit / width;
+    stride = 0;
+    ships.clear();
+    shots.clear();
+    marked.clear();
+    shot_cells = 0;
+    ship_of.clear();
+    cells_left.clear();
+    alive_cells = 0;
+    if (!sparse) {
+        stride = (width + 63) / 64;
+        ships.assign(stride * height, 0);
+        shots.assign(stride * height, 0);
+    }
+}
+//========================================
+
+//===============cells================
+char Board::Get(uint64_t x, uint64_t y) const {
+    if (!sparse) {
+        uint64_t word = y * stride + x / 64;
+        uint64_t bit = uint64_t(1) << (x % 64);
+        bool ship = ships[word] & bit;
+        if (shots[word] & bit) {
+            return ship ? 'X' : '*';
+        }
+        return ship ? 'S' : '.';
+    }
+    auto it = marked.find({x, y});
+    return it == marked.end() ? '.' : it->second;
+}
+
+void Board::Set(uint64_t x, uint64_t y, char value) {
+    char old = Get(x, y);
+    shot_cells -= old == 'X' || old == '*';
+    shot_cells += value == 'X' || value == '*';
+    if (!sparse) {
+        uint64_t word = y * stride + x / 64;
+        uint64_t bit = uint64_t(1) << (x % 64);
+        ships[word] &= ~bit;
+        shots[word] &= ~bit;
+        if (value == 'S' || value == 'X') {
+            ships[word] |= bit;
+        }
+        if (value == 'X' || value == '*') {
+            shots[word] |= bit;
+        }
+    } else if (value == '.') {
+        marked.erase({x, y});
+    } else {
+        marked[{x, y}] = value;
+    }
+}
+//====================================
+
+//===============queries===============
+bool Board::IsAreaFree(uint64_t x0, uint64_t y0, uint64_t x1,
+                       uint64_t y1) const {
+    if (sparse) {
+        for (uint64_t y = y0; y <= y1; ++y) {
+            for (uint64_t x = x0; x <= x1; ++x) {
+                char cell = Get(x, y);
+                if (cell == 'S' || cell == 'X') {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    uint64_t first = x0 / 64;
+    uint64_t last = x1 / 64;
+    uint64_t first_mask = ~uint64_t(0) << (x0 % 64);
+    uint64_t last_mask = ~uint64_t(0) >> (63 - x1 % 64);
+    for (uint64_t y = y0; y <= y1; ++y) {
+        const uint64_t* row = ships.data() + y * stride;
+        for (uint64_t word = first; word <= last; ++word) {
+            uint64_t mask = ~uint64_t(0);
+            if (word == first) {
+                mask &= first_mask;
+            }
+            if (word == last) {
+                mask &= last_mask;
+            }
+            if (row[word] & mask) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Board::FindUnshot(uint64_t n, uint64_t& x, uint64_t& y) const {
+    if (sparse) {
+        return false;
+    }
+    // Padding bits past the width count as shot
+    uint64_t tail = width % 64 == 0 ? ~uint64_t(0)
+                                    : (uint64_t(1) << (width % 64)) - 1;
+    for (uint64_t row = 0; row < height; ++row) {
+        for (uint64_t word = 0; word < stride; ++word) {
+            uint64_t free = ~shots[row * stride + word];
+            if (word == stride - 1) {
+                free &= tail;
+            }
+            uint64_t count = __builtin_popcountll(free);
+            if (n >= count) {
+                n -= count;
+                continue;
+            }
+            for (; n > 0; --n) {
+                free &= free - 1;
+            }
+            x = word * 64 + __builtin_ctzll(free);
+            y = row;
+            return true;
+        }
+    }
+    return false;
+}
+//=====================================
+
+//================fleet================
+void Board::Reserve(uint64_t ship_count, uint64_t ship_cells) {
+    cells_left.reserve(ship_count);
+    ship_of.reserve(ship_cells);
+    if (sparse) {
+        marked.reserve(ship_cells);
+    }
+}
+
+void Board::AddShip(int length, char type, uint64_t x, uint64_t y) {
+    uint32_t id = static_cast<uint32_t>(cells_left.size());
+    cells_left.push_back(length);
+    alive_cells += length;
+    for (int i = 0; i < length; ++i) {
+        uint64_t nx = (type == 'h') ? x + i : x;
+        uint64_t ny = (type == 'h') ? y : y + i;
+        Set(nx, ny, 'S');
+        ship_of[{nx, ny}] = id;
+    }
+}
+
+bool Board::Hit(uint64_t x, uint64_t y) {
+    Set(x, y, 'X');
+    --alive_cells;
+    return --cells_left[ship_of.at({x, y})] == 0;
+}
+
+bool Board::IsSunk(uint64_t x, uint64_t y) const {
+    auto it = ship_of.find({x, y});
+    return it == ship_of.end() || cells_left[it->second] == 0;
+}
+//=====================================
@@ -0,0 +1,316 @@
+#include "../incl/density_strategy.h"
+
+#include <climits>
+#include <ctime>
+#include <iostream>
+
+//==============Сonstructor===============
+DensityStrategy::DensityStrategy(BattleField& enemy_battlefield,
+                                 BattleField& battlefield,
+                                 GameInfo& game_info)
+    : battlefield(battlefield),
+      enemy_battlefield(enemy_battlefield),
+      game_info(game_info),
+      width(enemy_battlefield.GetWidth()),
+      height(enemy_battlefield.GetHeight()),
+      random(game_info.seed != 0 ? game_info.seed
+                                 : static_cast<uint64_t>(time(0))) {
+    for (int i = 0; i < 4; ++i) {
+        remaining[i] = game_info.count[i];
+    }
+    dense = width != 0 && !(height > kDenseLimit / width);
+    if (!dense) {
+        known.Reset(width, height);
+        return;
+    }
+    uint64_t area = width * height;
+    blocked.assign(area, 0);
+    // One extra slot for the padding leaves of the tree, see Recompute
+    density.assign(area + 1, 0);
+    density[area] = INT32_MIN;
+    while (leaves < area) {
+        leaves *= 2;
+    }
+    tree.assign(2 * leaves, 0);
+    Recompute();
+}
+//========================================
+
+//===============cells================
+bool DensityStrategy::IsKnown(uint64_t x, uint64_t y) const {
+    if (!dense) {
+        return known.Get(x, y) != '.';
+    }
+    return density[y * width + x] < 0;
+}
+
+void DensityStrategy::MarkKnown(uint64_t x, uint64_t y) {
+    if (!dense) {
+        known.Set(x, y, '*');
+        return;
+    }
+    uint32_t cell = static_cast<uint32_t>(y * width + x);
+    density[cell] = -1;
+    UpdateTree(cell);
+}
+
+// The cell can no longer hold a ship: every placement through it that was
+// still possible stops counting
+void DensityStrategy::Block(uint64_t x, uint64_t y) {
+    if (!dense || blocked[y * width + x]) {
+        return;
+    }
+    for (int length = 1; length <= 4; ++length) {
+        if (remaining[length - 1] == 0) {
+            continue;
+        }
+        for (int vertical = 0; vertical <= (length > 1 ? 1 : 0); ++vertical) {
+            uint64_t along = vertical ? y : x;
+            uint64_t side = vertical ? height : width;
+            for (uint64_t i = 0; i < static_cast<uint64_t>(length); ++i) {
+                if (along < i || along - i + length > side) {
+                    continue;
+                }
+                uint64_t ax = vertical ? x : x - i;
+                uint64_t ay = vertical ? y - i : y;
+                if (IsPlacementFree(length, vertical, ax, ay)) {
+                    AddPlacement(length, vertical, ax, ay, -1);
+                }
+            }
+        }
+    }
+    blocked[y * width + x] = 1;
+}
+//====================================
+
+//==============density==============
+bool DensityStrategy::IsPlacementFree(int length, bool vertical, uint64_t x,
+                                      uint64_t y) const {
+    for (int i = 0; i < length; ++i) {
+        uint64_t nx = vertical ? x : x + i;
+        uint64_t ny = vertical ? y + i : y;
+        if (blocked[ny * width + nx]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DensityStrategy::AddPlacement(int length, bool vertical, uint64_t x,
+                                   uint64_t y, int32_t delta) {
+    for (int i = 0; i < length; ++i) {
+        uint64_t nx = vertical ? x : x + i;
+        uint64_t ny = vertical ? y + i : y;
+        uint32_t cell = static_cast<uint32_t>(ny * width + nx);
+        density[cell] += delta;
+        UpdateTree(cell);
+    }
+}
+
+// Full recount, only when a ship length runs out
+void DensityStrategy::Recompute() {
+    uint64_t area = width * height;
+    for (uint64_t cell = 0; cell < area; ++cell) {
+        if (density[cell] >= 0) {
+            density[cell] = 0;
+        }
+    }
+    for (int length = 1; length <= 4; ++length) {
+        if (remaining[length - 1] == 0) {
+            continue;
+        }
+        for (int vertical = 0; vertical <= (length > 1 ? 1 : 0); ++vertical) {
+            if (static_cast<uint64_t>(length) > (vertical ? height : width)) {
+                continue;
+            }
+            uint64_t max_x = vertical ? width : width - length + 1;
+            uint64_t max_y = vertical ? height - length + 1 : height;
+            for (uint64_t y = 0; y < max_y; ++y) {
+                for (uint64_t x = 0; x < max_x; ++x) {
+                    if (!IsPlacementFree(length, vertical, x, y)) {
+                        continue;
+                    }
+                    for (int i = 0; i < length; ++i) {
+                        uint64_t nx = vertical ? x : x + i;
+                        uint64_t ny = vertical ? y + i : y;
+                        ++density[ny * width + nx];
+                    }
+                }
+            }
+        }
+    }
+
+    // Leaves past the board point at the sentinel slot and never win
+    for (uint32_t leaf = 0; leaf < leaves; ++leaf) {
+        tree[leaves + leaf] = leaf < area ? leaf : static_cast<uint32_t>(area);
+    }
+    for (uint32_t node = leaves - 1; node > 0; --node) {
+        uint32_t left = tree[2 * node];
+        uint32_t right = tree[2 * node + 1];
+        tree[node] = density[left] >= density[right] ? left : right;
+    }
+}
+
+void DensityStrategy::UpdateTree(uint32_t cell) {
+    for (uint32_t node = (leaves + cell) / 2; node > 0; node /= 2) {
+        uint32_t left = tree[2 * node];
+        uint32_t right = tree[2 * node + 1];
+        tree[node] = density[left] >= density[right] ? left : right;
+    }
+}
+//===================================
+
+//===============result===============
+void DensityStrategy::Observe(const std::string& result) {
+    pending = false;
+    if (result != "miss" && result != "hit" && result != "kill") {
+        // "already shot" and the like: never pick the cell again and drop
+        // its placements from the density counts as well
+        if (!IsKnown(last_x, last_y)) {
+            Block(last_x, last_y);
+            MarkKnown(last_x, last_y);
+        }
+        return;
+    }
+    Block(last_x, last_y);
+    MarkKnown(last_x, last_y);
+    if (result == "miss") {
+        return;
+    }
+
+    // Ships never touch, not even by a corner
+    hits.push_back({last_x, last_y});
+    for (int dy = -1; dy <= 1; dy += 2) {
+        for (int dx = -1; dx <= 1; dx += 2) {
+            uint64_t nx = last_x + dx;
+            uint64_t ny = last_y + dy;
+            if (nx < width && ny < height && !IsKnown(nx, ny)) {
+                Block(nx, ny);
+                MarkKnown(nx, ny);
+            }
+        }
+    }
+    if (result == "hit") {
+        return;
+    }
+
+    for (const auto& hit : hits) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                uint64_t nx = hit.first + dx;
+                uint64_t ny = hit.second + dy;
+                if (nx < width && ny < height && !IsKnown(nx, ny)) {
+                    Block(nx, ny);
+                    MarkKnown(nx, ny);
+                }
+            }
+        }
+    }
+    size_t length = hits.size();
+    hits.clear();
+    if (length >= 1 && length <= 4 && remaining[length - 1] > 0 &&
+        --remaining[length - 1] == 0 && dense) {
+        Recompute();
+    }
+}
+//====================================
+
+//===============choose===============
+// Next cell of the damaged ship: its line ends, or any side of one hit
+bool DensityStrategy::ChooseTarget(uint64_t& x, uint64_t& y) {
+    std::vector<std::pair<uint64_t, uint64_t>> candidates;
+    if (hits.size() == 1) {
+        uint64_t hx = hits[0].first;
+        uint64_t hy = hits[0].second;
+        candidates = {{hx - 1, hy}, {hx + 1, hy}, {hx, hy - 1}, {hx, hy + 1}};
+    } else {
+        bool horizontal = hits[0].second == hits[1].second;
+        uint64_t low = UINT64_MAX;
+        uint64_t high = 0;
+        for (const auto& hit : hits) {
+            uint64_t along = horizontal ? hit.first : hit.second;
+            low = along < low ? along : low;
+            high = along > high ? along : high;
+        }
+        if (horizontal) {
+            candidates = {{low - 1, hits[0].second}, {high + 1, hits[0].second}};
+        } else {
+            candidates = {{hits[0].first, low - 1}, {hits[0].first, high + 1}};
+        }
+    }
+
+    bool found = false;
+    int32_t best = -1;
+    for (const auto& candidate : candidates) {
+        // Coordinates wrap around below zero, so one check covers both sides
+        if (candidate.first >= width || candidate.second >= height ||
+            IsKnown(candidate.first, candidate.second)) {
+            continue;
+        }
+        int32_t value =
+            dense ? density[candidate.second * width + candidate.first] : 0;
+        if (!found || value > best) {
+            x = candidate.first;
+            y = candidate.second;
+            best = value;
+            found = true;
+        }
+    }
+    if (!found) {
+        hits.clear();  // Results did not add up, back to hunting
+    }
+    return found;
+}
+
+bool DensityStrategy::ChooseHunt(uint64_t& x, uint64_t& y) {
+    if (dense) {
+        uint32_t cell = tree[1];
+        if (density[cell] < 0) {
+            return false;
+        }
+        x = cell % width;
+        y = cell / width;
+        return true;
+    }
+    const int kTries = 1000;
+    for (int tries = 0; tries < kTries; ++tries) {
+        x = random() % width;
+        y = random() % height;
+        if (!IsKnown(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+//====================================
+
+bool DensityStrategy::NextShot(uint64_t& x, uint64_t& y) {
+    if (!(!hits.empty() && ChooseTarget(x, y)) && !ChooseHunt(x, y)) {
+        return false;
+    }
+    last_x = x;
+    last_y = y;
+    pending = true;
+    return true;
+}
+
+void DensityStrategy::Execute() {
+    if (pending) {
+        // A result from "set result" wins over the local enemy board
+        Observe(game_info.last_shot_result.empty() ? local_result
+                                                   : game_info.last_shot_result);
+    }
+
+    uint64_t x, y;
+    if (!NextShot(x, y)) {
+        std::cout << "DensityStrategy: All possible shots are completed."
+                  << '\n';
+        return;
+    }
+
+    local_result =
+        enemy_battlefield.Shoot(x, y, enemy_battlefield.battlefield);
+    game_info.last_shot_result = "";
+    std::cout << "DensityStrategy: shoots at: (" << x << ", " << y << ')'
+              << '\n';
+}
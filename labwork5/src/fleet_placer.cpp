@@ -0,0 +1,202 @@
+#include "../incl/fleet_placer.h"
+
+//==============Сonstructor===============
+FleetPlacer::FleetPlacer(uint64_t width, uint64_t height, uint64_t seed)
+    : width(width), height(height), random(seed) {}
+//========================================
+
+//==============feasibility===============
+bool FleetPlacer::IsFeasible(const uint64_t count[4]) const {
+    if (width == 0 || height == 0) {
+        return false;
+    }
+    unsigned __int128 needed = 0;
+    int longest = 0;
+    for (int length = 1; length <= 4; ++length) {
+        if (count[length - 1] > 0) {
+            needed += static_cast<unsigned __int128>(count[length - 1]) *
+                      ((length + 1) * 2);
+            longest = length;
+        }
+    }
+    unsigned __int128 available =
+        static_cast<unsigned __int128>(width + 1) * (height + 1);
+    return needed <= available &&
+           (static_cast<uint64_t>(longest) <= width ||
+            static_cast<uint64_t>(longest) <= height);
+}
+//========================================
+
+//=================place==================
+bool FleetPlacer::Place(const uint64_t count[4]) {
+    if (!IsFeasible(count)) {
+        return false;
+    }
+    bool dense = !(height > kDenseLimit / width);
+    for (int attempt = 0; attempt < kAttempts; ++attempt) {
+        placements.clear();
+        if (dense ? PlaceDense(count) : PlaceSparse(count)) {
+            return true;
+        }
+    }
+    placements.clear();
+    return false;
+}
+//========================================
+
+//=================dense==================
+// Anchor of a ship: orientation * area + y * width + x
+bool FleetPlacer::PlaceDense(const uint64_t count[4]) {
+    uint64_t area = width * height;
+    blocked.assign(area, 0);
+    position.assign(2 * area, kNone);
+    anchors.clear();
+
+    for (int length = 4; length >= 1; --length) {
+        if (count[length - 1] == 0) {
+            continue;
+        }
+        CollectAnchors(length);
+        for (uint64_t i = 0; i < count[length - 1]; ++i) {
+            if (anchors.empty()) {
+                return false;
+            }
+            uint32_t anchor = anchors[random() % anchors.size()];
+            char type = anchor < area ? 'h' : 'v';
+            uint64_t cell = anchor % area;
+            uint64_t x = cell % width;
+            uint64_t y = cell / width;
+            placements.push_back({length, type, x, y});
+            Block(length, type, x, y);
+        }
+    }
+    return true;
+}
+
+// Every anchor whose cells are all free; runs of free cells are counted
+// along rows and columns so the scan is linear in the area
+void FleetPlacer::CollectAnchors(int length) {
+    for (uint32_t anchor : anchors) {
+        position[anchor] = kNone;
+    }
+    anchors.clear();
+    uint64_t area = width * height;
+    auto add = [this](uint32_t anchor) {
+        position[anchor] = static_cast<uint32_t>(anchors.size());
+        anchors.push_back(anchor);
+    };
+
+    for (uint64_t y = 0; y < height; ++y) {
+        uint64_t run = 0;
+        for (uint64_t x = 0; x < width; ++x) {
+            run = blocked[y * width + x] ? 0 : run + 1;
+            if (run >= static_cast<uint64_t>(length)) {
+                add(static_cast<uint32_t>(y * width + x - length + 1));
+            }
+        }
+    }
+    if (length == 1) {
+        return;  // A single cell has no orientation
+    }
+    std::vector<uint64_t> runs(width, 0);
+    for (uint64_t y = 0; y < height; ++y) {
+        for (uint64_t x = 0; x < width; ++x) {
+            runs[x] = blocked[y * width + x] ? 0 : runs[x] + 1;
+            if (runs[x] >= static_cast<uint64_t>(length)) {
+                add(static_cast<uint32_t>(area + (y - length + 1) * width + x));
+            }
+        }
+    }
+}
+
+void FleetPlacer::RemoveAnchor(uint32_t anchor) {
+    uint32_t index = position[anchor];
+    if (index == kNone) {
+        return;
+    }
+    uint32_t last = anchors.back();
+    anchors[index] = last;
+    position[last] = index;
+    anchors.pop_back();
+    position[anchor] = kNone;
+}
+
+// Blocks the ship with its halo and drops every anchor of the current
+// length that crosses a newly blocked cell
+void FleetPlacer::Block(int length, char type, uint64_t x, uint64_t y) {
+    uint64_t area = width * height;
+    uint64_t right = (type == 'h') ? x + length : x + 1;
+    uint64_t bottom = (type == 'h') ? y + 1 : y + length;
+    uint64_t left = x > 0 ? x - 1 : 0;
+    uint64_t top = y > 0 ? y - 1 : 0;
+    right = right < width ? right : width - 1;
+    bottom = bottom < height ? bottom : height - 1;
+
+    for (uint64_t cy = top; cy <= bottom; ++cy) {
+        for (uint64_t cx = left; cx <= right; ++cx) {
+            if (blocked[cy * width + cx]) {
+                continue;
+            }
+            blocked[cy * width + cx] = 1;
+            for (uint64_t i = 0; i < static_cast<uint64_t>(length); ++i) {
+                if (cx >= i) {
+                    RemoveAnchor(static_cast<uint32_t>(cy * width + cx - i));
+                }
+                if (cy >= i) {
+                    RemoveAnchor(
+                        static_cast<uint32_t>(area + (cy - i) * width + cx));
+                }
+            }
+        }
+    }
+}
+//========================================
+
+//=================sparse=================
+bool FleetPlacer::PlaceSparse(const uint64_t count[4]) {
+    occupied.Reset(width, height);
+    for (int length = 4; length >= 1; --length) {
+        // Only orientations that fit on the board, as in CollectAnchors
+        uint64_t ship = static_cast<uint64_t>(length);
+        bool horizontal = ship <= width;
+        bool vertical = length > 1 && ship <= height;
+        for (uint64_t i = 0; i < count[length - 1]; ++i) {
+            bool placed = false;
+            for (int tries = 0; tries < kSparseTriesPerShip && !placed;
+                 ++tries) {
+                if (!horizontal && !vertical) {
+                    break;
+                }
+                char type = !horizontal ? 'v'
+                            : !vertical ? 'h'
+                            : random() % 2 == 1 ? 'v'
+                                                : 'h';
+                uint64_t max_x = (type == 'h') ? width - length : width - 1;
+                uint64_t max_y = (type == 'h') ? height - 1 : height - length;
+                uint64_t x = random() % (max_x + 1);
+                uint64_t y = random() % (max_y + 1);
+                if (IsFree(length, type, x, y)) {
+                    occupied.AddShip(length, type, x, y);
+                    placements.push_back({length, type, x, y});
+                    placed = true;
+                }
+            }
+            if (!placed) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// No ship cell in the rectangle around the new ship
+bool FleetPlacer::IsFree(int length, char type, uint64_t x, uint64_t y) const {
+    uint64_t right = (type == 'h') ? x + length : x + 1;
+    uint64_t bottom = (type == 'h') ? y + 1 : y + length;
+    uint64_t left = x > 0 ? x - 1 : 0;
+    uint64_t top = y > 0 ? y - 1 : 0;
+    right = right < width ? right : width - 1;
+    bottom = bottom < height ? bottom : height - 1;
+    return occupied.IsAreaFree(left, top, right, bottom);
+}
+//========================================
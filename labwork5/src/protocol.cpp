@@ -0,0 +1,208 @@
+#include "../incl/protocol.h"
+
+#include <charconv>
+#include <iostream>
+#include <string>
+
+#include "../incl/strategy.h"
+#include "../incl/strategy_manager.h"
+
+//=================text=================
+Command ParseCommand(std::string_view word) {
+    switch (word.size()) {
+    case 3:
+        if (word == "set") return Command::kSet;
+        if (word == "get") return Command::kGet;
+        if (word == "win") return Command::kWin;
+        break;
+    case 4:
+        switch (word[0]) {
+        case 'p':
+            if (word == "ping") return Command::kPing;
+            break;
+        case 'e':
+            if (word == "exit") return Command::kExit;
+            break;
+        case 's':
+            if (word == "shot") return Command::kShot;
+            if (word == "stop") return Command::kStop;
+            break;
+        case 'd':
+            if (word == "dump") return Command::kDump;
+            break;
+        case 'l':
+            if (word == "load") return Command::kLoad;
+            if (word == "lose") return Command::kLose;
+            break;
+        case 'h':
+            if (word == "help") return Command::kHelp;
+            break;
+        }
+        break;
+    case 5:
+        if (word == "start") return Command::kStart;
+        break;
+    case 6:
+        if (word == "create") return Command::kCreate;
+        break;
+    case 8:
+        if (word == "finished") return Command::kFinished;
+        break;
+    }
+    return Command::kUnknown;
+}
+
+std::string_view NextWord(std::string_view& line) {
+    size_t pos = line.find(' ');
+    std::string_view word = line.substr(0, pos);
+    line = pos == std::string_view::npos ? std::string_view()
+                                         : line.substr(pos + 1);
+    return word;
+}
+
+bool ParseUint64(std::string_view text, uint64_t& value) {
+    const char* end = text.data() + text.size();
+    auto [ptr, error] = std::from_chars(text.data(), end, value);
+    return error == std::errc() && ptr == end && !text.empty();
+}
+//======================================
+
+void FlushIfInputDrained() {
+    if (std::cin.rdbuf()->in_avail() <= 0) {
+        std::cout.flush();
+    }
+}
+
+//================binary================
+namespace {
+
+bool ReadBytes(char* data, size_t size) {
+    FlushIfInputDrained();
+    return static_cast<bool>(std::cin.read(data, size));
+}
+
+bool ReadUint64(uint64_t& value) {
+    unsigned char bytes[8];
+    if (!ReadBytes(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+        return false;
+    }
+    value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = value << 8 | bytes[i];
+    }
+    return true;
+}
+
+void WriteUint64(uint64_t value) {
+    char bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<char>(value >> (8 * i));
+    }
+    std::cout.write(bytes, sizeof(bytes));
+}
+
+char ResultCode(const std::string& result) {
+    if (result == "miss") return binary_protocol::kMiss;
+    if (result == "hit") return binary_protocol::kHit;
+    if (result == "kill") return binary_protocol::kKill;
+    return binary_protocol::kFailed;
+}
+
+}  // namespace
+
+bool RunBinarySession(BattleField* battlefield, BattleField* enemy_battlefield,
+                      GameInfo& game_info) {
+    namespace bp = binary_protocol;
+    bool ready = battlefield && enemy_battlefield;
+
+    // Result of our last shot on the local board, observed when the peer
+    // does not send its own before the next shot
+    bool pending = false;
+    std::string local_result;
+
+    char opcode;
+    while (ReadBytes(&opcode, 1)) {
+        switch (opcode) {
+        case bp::kShotAt: {
+            uint64_t x, y;
+            if (!ReadUint64(x) || !ReadUint64(y)) {
+                return true;
+            }
+            if (!ready || !game_info.enemy_shot_done ||
+                x >= battlefield->GetWidth() ||
+                y >= battlefield->GetHeight()) {
+                std::cout.put(bp::kFailed);
+                break;
+            }
+            std::cout.put(ResultCode(
+                battlefield->Shoot(x, y, enemy_battlefield->battlefield)));
+            game_info.enemy_shot_done = false;
+            break;
+        }
+        case bp::kShot: {
+            Strategy* strategy = StrategyManager::GetStrategy();
+            uint64_t x, y;
+            if (ready && strategy && pending) {
+                strategy->Observe(local_result);
+                pending = false;
+            }
+            if (!ready || !strategy || !strategy->NextShot(x, y)) {
+                std::cout.put(bp::kFailed);
+                break;
+            }
+            local_result = battlefield->Shoot(x, y, battlefield->battlefield);
+            pending = true;
+            game_info.enemy_shot_done = true;
+            std::cout.put(bp::kOk);
+            WriteUint64(x);
+            WriteUint64(y);
+            break;
+        }
+        case bp::kResult: {
+            char code;
+            if (!ReadBytes(&code, 1)) {
+                return true;
+            }
+            const char* result = code == bp::kMiss   ? "miss"
+                                 : code == bp::kHit  ? "hit"
+                                 : code == bp::kKill ? "kill"
+                                                     : nullptr;
+            Strategy* strategy = StrategyManager::GetStrategy();
+            if (!result || !game_info.enemy_shot_done) {
+                std::cout.put(bp::kFailed);
+                break;
+            }
+            game_info.last_shot_result = result;
+            if (strategy && pending) {
+                strategy->Observe(result);
+                pending = false;
+            }
+            std::cout.put(bp::kOk);
+            break;
+        }
+        case bp::kFinished:
+        case bp::kWin:
+        case bp::kLose: {
+            bool win = ready &&
+                       enemy_battlefield->battlefield.GetAliveCells() == 0;
+            bool lose = ready && battlefield->battlefield.GetAliveCells() == 0;
+            bool answer = opcode == bp::kWin    ? win
+                          : opcode == bp::kLose ? lose
+                                                : win || lose;
+            std::cout.put(answer ? bp::kYes : bp::kNo);
+            break;
+        }
+        case bp::kText:
+            std::cout.put(bp::kOk);
+            return false;
+        case bp::kExit:
+            std::cout.put(bp::kOk);
+            return true;
+        default:
+            std::cout.put(bp::kFailed);
+            break;
+        }
+    }
+    return true;
+}
+//======================================
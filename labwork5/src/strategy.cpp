@@ -5,38 +5,42 @@
 #include <string>
 
 #include "../incl/battlefield.h"
+#include "../incl/density_strategy.h"
+#include "../incl/fleet_placer.h"
 
 //================ordered================
-void OrderedStrategy::Execute() {
+bool OrderedStrategy::NextShot(uint64_t& x, uint64_t& y) {
     if (current_y >= enemy_battlefield.GetHeight()) {
-        std::cout << "OrderedStrategy: All possible shots are completed."
-                  << '\n';
-        return;
+        return false;
     }
-
-    std::cout << "OrderedStrategy: shoots at: (" << current_x << ", "
-              << current_y << ")\n";
-
-    enemy_battlefield.Shoot(current_x, current_y,
-                            enemy_battlefield.battlefield, game_info);
+    x = current_x;
+    y = current_y;
     ++current_x;
     if (current_x >= enemy_battlefield.GetWidth()) {
         current_x = 0;
         ++current_y;
     }
+    return true;
 }
 
-//======================================
+void OrderedStrategy::Execute() {
+    uint64_t x, y;
+    if (!NextShot(x, y)) {
+        std::cout << "OrderedStrategy: All possible shots are completed."
+                  << '\n';
+        return;
+    }
 
-//================custom================
+    std::cout << "OrderedStrategy: shoots at: (" << x << ", " << y << ")\n";
 
-void CustomStrategy::Execute() {
-    static bool hit = false;
-    static uint64_t last_x = 0;
-    static uint64_t last_y = 0;
+    enemy_battlefield.Shoot(x, y, enemy_battlefield.battlefield);
+}
 
-    uint64_t x, y;
+//======================================
 
+//================custom================
+
+bool CustomStrategy::NextShot(uint64_t& x, uint64_t& y) {
     if (hit) {
         bool found = false;
         for (int dx = -1; dx <= 1 && !found; ++dx) {
@@ -46,8 +50,8 @@ void CustomStrategy::Execute() {
                 uint64_t ny = last_y + dy;
                 if (nx < enemy_battlefield.GetWidth() &&
                     ny < enemy_battlefield.GetHeight() &&
-                    enemy_battlefield.battlefield[ny][nx] != 'X' &&
-                    enemy_battlefield.battlefield[ny][nx] != '*') {
+                    enemy_battlefield.battlefield.Get(nx, ny) != 'X' &&
+                    enemy_battlefield.battlefield.Get(nx, ny) != '*') {
                     x = nx;
                     y = ny;
                     found = true;
@@ -56,54 +60,77 @@ void CustomStrategy::Execute() {
         }
         if (!found) {
             hit = false;
-        }  
+        }
     }
 
-    if (!hit) {
-        do {
-            x = rand() % enemy_battlefield.GetWidth();
-            y = rand() % enemy_battlefield.GetHeight();
-        } while (enemy_battlefield.battlefield[y][x] == 'X' ||
-                 enemy_battlefield.battlefield[y][x] == '*');
+    if (!hit && !PickUnshot(x, y)) {
+        return false;
     }
+    last_x = x;
+    last_y = y;
+    return true;
+}
+
+// Random cells first; once they keep landing on shots, a uniform pick
+// among the unshot cells counted word by word on the shot plane
+bool CustomStrategy::PickUnshot(uint64_t& x, uint64_t& y) {
+    const Board& board = enemy_battlefield.battlefield;
+    const int kTries = 64;
+    for (int tries = 0; tries < kTries || board.IsSparse(); ++tries) {
+        x = random() % enemy_battlefield.GetWidth();
+        y = random() % enemy_battlefield.GetHeight();
+        if (board.Get(x, y) != 'X' && board.Get(x, y) != '*') {
+            return true;
+        }
+    }
+    uint64_t unshot = board.GetWidth() * board.GetHeight() - board.CountShots();
+    return unshot > 0 && board.FindUnshot(random() % unshot, x, y);
+}
 
-    enemy_battlefield.Shoot(x, y, enemy_battlefield.battlefield, game_info);
+void CustomStrategy::Observe(const std::string& result) {
+    hit = result == "hit";
+}
+
+void CustomStrategy::Execute() {
+    uint64_t x, y;
+    if (!NextShot(x, y)) {
+        std::cout << "CustomStrategy: All possible shots are completed."
+                  << '\n';
+        return;
+    }
+
+    enemy_battlefield.Shoot(x, y, enemy_battlefield.battlefield);
     std::cout << "CustomStrategy: shoots at: (" << x << ", " << y << ')' << '\n';
 
-    if (game_info.last_shot_result == "hit") {
-        hit = true;
-        last_x = x;
-        last_y = y;
-    } else {
-        hit = false;
+    Observe(game_info.last_shot_result);
+}
+
+Strategy* MakeStrategy(const std::string& name, BattleField& enemy_battlefield,
+                       BattleField& battlefield, GameInfo& game_info) {
+    if (name == "ordered") {
+        return new OrderedStrategy(enemy_battlefield, battlefield, game_info);
+    } else if (name == "custom") {
+        return new CustomStrategy(enemy_battlefield, battlefield, game_info);
+    } else if (name == "density") {
+        return new DensityStrategy(enemy_battlefield, battlefield, game_info);
     }
+    return nullptr;
 }
 
 bool PlaceEnemyShips(BattleField& enemy_battlefield, const uint64_t count[4]) {
-    srand(static_cast<unsigned>(time(0)));
-
-    for (int length = 1; length <= 4; ++length) {
-        for (uint64_t i = 0; i < count[length - 1]; ++i) {
-            bool placed = false;
-            while (!placed) {
-                uint64_t x = rand() % enemy_battlefield.GetWidth();
-                uint64_t y = rand() % enemy_battlefield.GetHeight();
-                bool horizontal =
-                    rand() % 2 ==
-                    0; 
-
-                if (horizontal) {
-                    if (x + length <= enemy_battlefield.GetWidth()) {
-                        placed = enemy_battlefield.PutShip(
-                            length, 'h', x, y, enemy_battlefield.battlefield);
-                    }
-                } else {
-                    if (y + length <= enemy_battlefield.GetHeight()) {
-                        placed = enemy_battlefield.PutShip(
-                            length, 'v', x, y, enemy_battlefield.battlefield);
-                    }
-                }
-            }
+    return PlaceShips(enemy_battlefield, count,
+                      static_cast<uint64_t>(time(0)));
+}
+
+bool PlaceShips(BattleField& field, const uint64_t count[4], uint64_t seed) {
+    FleetPlacer placer(field.GetWidth(), field.GetHeight(), seed);
+    if (!placer.Place(count)) {
+        return false;
+    }
+    for (const FleetPlacer::Placement& ship : placer.placements) {
+        if (!field.PutShip(ship.length, ship.type, ship.x, ship.y,
+                           field.battlefield)) {
+            return false;
         }
     }
     return true;
@@ -0,0 +1,173 @@
+#include "../incl/tournament.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../incl/battlefield.h"
+#include "../incl/game_info.h"
+#include "../incl/strategy.h"
+
+namespace {
+
+// Seeds of the two fleets and two strategies of one game
+uint64_t MixSeed(uint64_t seed, uint64_t salt) {
+    uint64_t value = seed * 0x9E3779B97F4A7C15ULL + salt;
+    value ^= value >> 31;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    return (value ^ (value >> 29)) | 1;
+}
+
+double Percentile(std::vector<float>& values, double share) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(share * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}  // namespace
+
+//=================game=================
+GameRecord PlaySelfGame(const TournamentConfig& config, uint64_t seed,
+                        std::vector<float>& latencies) {
+    GameRecord record;
+    GameInfo infos[2];
+    for (int side = 0; side < 2; ++side) {
+        infos[side].player = side == 0 ? "master" : "slave";
+        infos[side].width = config.width;
+        infos[side].height = config.height;
+        std::copy(config.count, config.count + 4, infos[side].count);
+        infos[side].seed = MixSeed(seed, 2 + side);
+        infos[side].started = true;
+    }
+
+    BattleField fields[2] = {BattleField(config.width, config.height),
+                             BattleField(config.width, config.height)};
+    if (!PlaceShips(fields[0], config.count, MixSeed(seed, 0)) ||
+        !PlaceShips(fields[1], config.count, MixSeed(seed, 1))) {
+        return record;
+    }
+
+    // Every player shoots at the other one's field
+    std::unique_ptr<Strategy> players[2] = {
+        std::unique_ptr<Strategy>(MakeStrategy(
+            config.master_strategy, fields[1], fields[0], infos[0])),
+        std::unique_ptr<Strategy>(MakeStrategy(
+            config.slave_strategy, fields[0], fields[1], infos[1]))};
+    if (!players[0] || !players[1]) {
+        return record;
+    }
+
+    // More shots than cells means a strategy repeats itself
+    uint64_t limit = config.width * config.height + 1;
+    uint64_t shots[2] = {0, 0};
+    for (int turn = 0;; turn ^= 1) {
+        BattleField& target = fields[1 - turn];
+        auto start = std::chrono::steady_clock::now();
+        uint64_t x, y;
+        bool shot = players[turn]->NextShot(x, y);
+        if (shot) {
+            players[turn]->Observe(target.Shoot(x, y, target.battlefield));
+        }
+        latencies.push_back(std::chrono::duration<float, std::micro>(
+                                std::chrono::steady_clock::now() - start)
+                                .count());
+
+        if (!shot || ++shots[turn] > limit) {
+            return record;
+        }
+        if (target.battlefield.GetAliveCells() == 0) {
+            record.winner = turn;
+            record.shots = shots[turn];
+            return record;
+        }
+    }
+}
+//======================================
+
+//==============tournament==============
+bool RunTournament(const TournamentConfig& config, TournamentReport& report) {
+    BattleField probe(1, 1);
+    GameInfo probe_info;
+    for (const std::string& name :
+         {config.master_strategy, config.slave_strategy}) {
+        std::unique_ptr<Strategy> strategy(
+            MakeStrategy(name, probe, probe, probe_info));
+        if (!strategy) {
+            return false;
+        }
+    }
+
+    int threads = config.threads > 0
+                      ? config.threads
+                      : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(threads, 1);
+    int batch = std::max(config.batch, 1);
+
+    std::atomic<int> next_game(0);
+    std::mutex merge;
+    std::vector<float> latencies;
+    uint64_t winner_shots = 0;
+    report = TournamentReport();
+    report.games = config.games;
+
+    auto worker = [&]() {
+        std::vector<float> local_latencies;
+        int local_wins[2] = {0, 0};
+        int local_unfinished = 0;
+        uint64_t local_shots = 0;
+        while (true) {
+            int first = next_game.fetch_add(batch);
+            if (first >= config.games) {
+                break;
+            }
+            int last = std::min(first + batch, config.games);
+            for (int game = first; game < last; ++game) {
+                GameRecord record =
+                    PlaySelfGame(config, config.seed + game, local_latencies);
+                if (record.winner < 0) {
+                    ++local_unfinished;
+                } else {
+                    ++local_wins[record.winner];
+                    local_shots += record.shots;
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(merge);
+        latencies.insert(latencies.end(), local_latencies.begin(),
+                         local_latencies.end());
+        report.master_wins += local_wins[0];
+        report.slave_wins += local_wins[1];
+        report.unfinished += local_unfinished;
+        winner_shots += local_shots;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    report.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    int finished = report.master_wins + report.slave_wins;
+    report.average_shots_to_win =
+        finished > 0 ? static_cast<double>(winner_shots) / finished : 0;
+    report.games_per_second =
+        report.seconds > 0 ? config.games / report.seconds : 0;
+    report.latency_p50 = Percentile(latencies, 0.50);
+    report.latency_p90 = Percentile(latencies, 0.90);
+    report.latency_p99 = Percentile(latencies, 0.99);
+    report.latency_max = Percentile(latencies, 1.0);
+    return true;
+}
+//======================================